@@ -4,51 +4,111 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../source/adc_quality.c \
+../source/adc_stats.c \
+../source/arm_math_ref.c \
+../source/broadcast_ring.c \
 ../source/circular_buffer.c \
+../source/cycle_count.c \
 ../source/dac_adc.c \
-../source/dma.c \
+../source/dc_blocker.c \
+../source/decimator.c \
+../source/dsp_stats.c \
+../source/fft.c \
+../source/filter_chain.c \
+../source/goertzel.c \
 ../source/handle_led.c \
+../source/histogram.c \
+../source/isqrt.c \
 ../source/logger.c \
 ../source/main.c \
 ../source/mtb.c \
+../source/pingpong.c \
 ../source/post.c \
+../source/ring_notify.c \
+../source/ring_stats.c \
+../source/running_median.c \
 ../source/semihost_hardfault.c \
 ../source/setup_teardown.c \
 ../source/sine.c \
+../source/sliding_stats.c \
+../source/spsc_ring.c \
+../source/stream_stats.c \
 ../source/tasks.c \
 ../source/time.c \
+../source/trigger.c \
 ../source/uart.c 
 
 OBJS += \
+./source/adc_quality.o \
+./source/adc_stats.o \
+./source/arm_math_ref.o \
+./source/broadcast_ring.o \
 ./source/circular_buffer.o \
+./source/cycle_count.o \
 ./source/dac_adc.o \
-./source/dma.o \
+./source/dc_blocker.o \
+./source/decimator.o \
+./source/dsp_stats.o \
+./source/fft.o \
+./source/filter_chain.o \
+./source/goertzel.o \
 ./source/handle_led.o \
+./source/histogram.o \
+./source/isqrt.o \
 ./source/logger.o \
 ./source/main.o \
 ./source/mtb.o \
+./source/pingpong.o \
 ./source/post.o \
+./source/ring_notify.o \
+./source/ring_stats.o \
+./source/running_median.o \
 ./source/semihost_hardfault.o \
 ./source/setup_teardown.o \
 ./source/sine.o \
+./source/sliding_stats.o \
+./source/spsc_ring.o \
+./source/stream_stats.o \
 ./source/tasks.o \
 ./source/time.o \
+./source/trigger.o \
 ./source/uart.o 
 
 C_DEPS += \
+./source/adc_quality.d \
+./source/adc_stats.d \
+./source/arm_math_ref.d \
+./source/broadcast_ring.d \
 ./source/circular_buffer.d \
+./source/cycle_count.d \
 ./source/dac_adc.d \
-./source/dma.d \
+./source/dc_blocker.d \
+./source/decimator.d \
+./source/dsp_stats.d \
+./source/fft.d \
+./source/filter_chain.d \
+./source/goertzel.d \
 ./source/handle_led.d \
+./source/histogram.d \
+./source/isqrt.d \
 ./source/logger.d \
 ./source/main.d \
 ./source/mtb.d \
+./source/pingpong.d \
 ./source/post.d \
+./source/ring_notify.d \
+./source/ring_stats.d \
+./source/running_median.d \
 ./source/semihost_hardfault.d \
 ./source/setup_teardown.d \
 ./source/sine.d \
+./source/sliding_stats.d \
+./source/spsc_ring.d \
+./source/stream_stats.d \
 ./source/tasks.d \
 ./source/time.d \
+./source/trigger.d \
 ./source/uart.d 
 
 
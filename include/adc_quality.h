@@ -0,0 +1,76 @@
+/*
+ * @file adc_quality.h
+ * @brief Project 6
+ *
+ * @details Closed-loop converter quality: SNR, SINAD, ENOB, and gain and
+ *          offset error, measured on the sine that DAC0 drives into ADC0.
+ *
+ *          The stimulus frequency is known exactly (one cycle every
+ *          NUM_SINE_SAMPLES reads), so each block is fitted over whole
+ *          periods with a least-squares sine at that frequency, plus its
+ *          harmonics up to ADC_QUALITY_HARMONICS. Over whole periods the
+ *          fit terms are orthogonal, so every coefficient is a single
+ *          correlation. The fundamental is the signal, the harmonics are the
+ *          distortion, and what is left after the fit is the noise.
+ *
+ *          Gain and offset are against the nominal sine from sine.h, so they
+ *          cover the DAC and ADC together.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef ADC_QUALITY_H
+#define ADC_QUALITY_H
+
+#include <stdint.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief Whether dsp_callback reports converter quality on every block
+ */
+#ifndef ADC_QUALITY_ANALYSIS
+#define ADC_QUALITY_ANALYSIS (1)
+#endif
+
+/**
+ * @brief Highest harmonic counted as distortion rather than noise
+ */
+#ifndef ADC_QUALITY_HARMONICS
+#define ADC_QUALITY_HARMONICS 5
+#endif
+
+/**
+ * @brief Quality of one block
+ */
+typedef struct adc_quality_t {
+	uint32_t samples;       // whole periods of the sine that were fitted
+	int32_t snrCentiDb;     // signal over noise, harmonics excluded
+	int32_t sinadCentiDb;   // signal over noise and distortion
+	int32_t enobCentiBits;  // (SINAD - 1.76 dB) / 6.02 dB
+	int32_t gainErrorPpm;   // fitted over nominal amplitude, minus one
+	int32_t offsetErrorUv;  // fitted over nominal offset
+} adc_quality_t;
+
+/**
+ * @brief Measure converter quality on a block of the DAC stimulus
+ * @param inBlock 12 bit codes, starting anywhere in the sine's period
+ * @param inCount Samples in the block. The largest whole number of
+ *        periods is used, so at least NUM_SINE_SAMPLES.
+ * @param outQuality Results
+ * @return buff_err_invalid on a null argument or a block shorter than a period
+ */
+buff_err adc_quality_measure(const uint16_t* inBlock, uint32_t inCount, adc_quality_t* outQuality);
+
+/**
+ * @brief 10 log10(inNumerator / inDenominator) in hundredths of a dB.
+ *        A zero denominator is taken as 1.
+ */
+int32_t adc_quality_ratio_centidb(uint64_t inNumerator, uint64_t inDenominator);
+
+#endif
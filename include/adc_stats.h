@@ -0,0 +1,143 @@
+/*
+ * @file adc_stats.h
+ * @brief Project 6
+ *
+ * @details Converts statistics gathered on raw 12 bit ADC codes to
+ *          millivolts with integer arithmetic, once per report.
+ *
+ *          The samples themselves are never converted. stream_stats reduces
+ *          the codes, and only the handful of results pass through here, so
+ *          neither the per-sample loop nor the report needs soft-float.
+ *
+ *          Every conversion folds in a gain and offset calibration, so a
+ *          code becomes calibrated millivolts in one 32 bit multiply, an add
+ *          and a shift:
+ *
+ *              mV = (code * scale + bias) >> ADC_MV_SHIFT
+ *
+ *          A 4096 entry table would cost 8 KB of flash to save a single
+ *          cycle multiply, so there is none. Absolute values (samples,
+ *          min, max, mean) take the offset; differences (standard
+ *          deviation, amplitudes) take only the gain, through adc_span_to_mv.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef ADC_STATS_H
+#define ADC_STATS_H
+
+#include <stdint.h>
+#include "stream_stats.h"
+#include "circular_buffer.h"
+
+/**
+ * @brief ADC reference voltage in millivolts
+ */
+#define ADC_VREF_MV (3300u)
+
+/**
+ * @brief log2 of the number of ADC codes (12 bit single ended)
+ */
+#define ADC_RESOLUTION_BITS (12u)
+
+/**
+ * @brief Fractional bits of the calibrated scale
+ */
+#define ADC_MV_SHIFT (19u)
+
+/**
+ * @brief Calibration applied from boot: the converter reads
+ *        true mV * (1 + ADC_CAL_GAIN_PPM / 10^6) + ADC_CAL_OFFSET_UV / 1000.
+ *        0 and 0 give the nominal VREF / 4096 per code.
+ */
+#ifndef ADC_CAL_GAIN_PPM
+#define ADC_CAL_GAIN_PPM (0)
+#endif
+
+#ifndef ADC_CAL_OFFSET_UV
+#define ADC_CAL_OFFSET_UV (0)
+#endif
+
+/**
+ * @brief Largest calibration accepted: 10 % of gain, and VREF / 16 of offset,
+ *        which keeps code * scale + bias within 31 bits
+ */
+#define ADC_CAL_MAX_GAIN_PPM (100000)
+#define ADC_CAL_MAX_OFFSET_UV (206250) // VREF / 16
+
+/**
+ * @brief One report's worth of block statistics, in millivolts
+ */
+typedef struct adc_stats_report_t {
+	uint32_t count;       // samples in the window
+	uint32_t minMv;
+	uint32_t maxMv;
+	uint32_t meanMv;
+	uint32_t varianceMv2; // population variance, in mV^2
+	uint32_t stdDevMv;    // population standard deviation
+} adc_stats_report_t;
+
+/**
+ * @brief Set the calibration every conversion uses from now on
+ * @param inGainErrorPpm Converter gain over nominal, minus one, in ppm
+ * @param inOffsetErrorUv Reading at 0 V, in microvolts
+ * @return buff_err_invalid, leaving the calibration unchanged, when either
+ *         is beyond ADC_CAL_MAX_GAIN_PPM or ADC_CAL_MAX_OFFSET_UV
+ *
+ * adc_quality.h measures the gain error directly. Its offset error is at the
+ * sine's mid-point, so the offset at 0 V is that minus the gain error's
+ * share of the mid-point voltage.
+ */
+buff_err adc_calibrate(int32_t inGainErrorPpm, int32_t inOffsetErrorUv);
+
+/**
+ * @brief Convert one ADC code to calibrated millivolts, rounded to nearest
+ *        and clamped at 0
+ * @param inCode 12 bit ADC code
+ */
+uint32_t adc_code_to_mv(uint32_t inCode);
+
+/**
+ * @brief Convert a difference of ADC codes, such as a standard deviation
+ *        or an amplitude, to millivolts. Gain only, rounded to nearest.
+ * @param inCodes Up to 4095 codes
+ */
+uint32_t adc_span_to_mv(uint32_t inCodes);
+
+/**
+ * @brief Convert calibrated millivolts to the nearest ADC code, the inverse
+ *        of adc_code_to_mv, e.g. for thresholds compared against raw codes
+ * @param inMv Millivolts at the ADC input
+ * @return The code, clamped to 0 to 4095
+ */
+uint16_t adc_mv_to_code(uint32_t inMv);
+
+/**
+ * @brief Convert a difference in millivolts, such as a hysteresis, to the
+ *        nearest number of codes. Gain only, the inverse of adc_span_to_mv.
+ * @param inMv Up to ADC_VREF_MV
+ */
+uint16_t adc_mv_to_span(uint32_t inMv);
+
+/**
+ * @brief Convert a block of ADC codes to calibrated millivolts
+ * @param inCodes 12 bit ADC codes
+ * @param outMv Millivolts, one per code; may be inCodes
+ * @param inCount Codes in the block
+ */
+void adc_block_to_mv(const uint16_t* inCodes, uint16_t* outMv, uint32_t inCount);
+
+/**
+ * @brief Convert statistics of ADC codes to millivolts
+ * @param inStats Window of raw 12 bit codes
+ * @param outReport Results, rounded to nearest. All zero for an empty window.
+ */
+void adc_stats_report(const stream_stats_t* inStats, adc_stats_report_t* outReport);
+
+#endif
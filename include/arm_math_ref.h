@@ -0,0 +1,157 @@
+/*
+ * @file arm_math_ref.h
+ * @brief Project 6
+ *
+ * @details Portable C versions of the CMSIS-DSP kernels this project uses,
+ *          with the same types and signatures as CMSIS/arm_math.h.
+ *
+ *          They stand in for the library when it is not linked, and let the
+ *          kernels be unit-tested and benchmarked on the PC. They follow the
+ *          library's fixed-point formats and rounding, but are written for
+ *          clarity rather than the library's unrolled loops, so results may
+ *          differ from it in the last bit.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef ARM_MATH_REF_H
+#define ARM_MATH_REF_H
+
+#include <stdint.h>
+
+/**
+ * @brief Error status returned by some kernels. Same values as arm_math.h.
+ */
+typedef enum
+{
+	ARM_MATH_SUCCESS = 0,
+	ARM_MATH_ARGUMENT_ERROR = -1
+} arm_status;
+
+/**
+ * @brief Fractional types in 1.15, 1.31 and 1.63 format
+ */
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+
+/**
+ * @brief Scale a vector by a power of two, saturating. Positive shifts go left.
+ */
+void arm_shift_q15(q15_t * pSrc, int8_t shiftBits, q15_t * pDst, uint32_t blockSize);
+
+/**
+ * @brief Square root of a non-negative 1.15 value
+ */
+arm_status arm_sqrt_q15(q15_t in, q15_t * pOut);
+
+/**
+ * @brief Square root of a non-negative 1.31 value
+ */
+arm_status arm_sqrt_q31(q31_t in, q31_t * pOut);
+
+/**
+ * @brief Largest value and the index of its first occurrence
+ */
+void arm_max_q15(q15_t * pSrc, uint32_t blockSize, q15_t * pResult, uint32_t * pIndex);
+void arm_max_q31(q31_t * pSrc, uint32_t blockSize, q31_t * pResult, uint32_t * pIndex);
+
+/**
+ * @brief Smallest value and the index of its first occurrence
+ */
+void arm_min_q15(q15_t * pSrc, uint32_t blockSize, q15_t * pResult, uint32_t * pIndex);
+void arm_min_q31(q31_t * pSrc, uint32_t blockSize, q31_t * pResult, uint32_t * pIndex);
+
+/**
+ * @brief Mean, truncated toward zero
+ */
+void arm_mean_q15(q15_t * pSrc, uint32_t blockSize, q15_t * pResult);
+void arm_mean_q31(q31_t * pSrc, uint32_t blockSize, q31_t * pResult);
+
+/**
+ * @brief Sample standard deviation (divides by blockSize - 1)
+ */
+void arm_std_q15(q15_t * pSrc, uint32_t blockSize, q15_t * pResult);
+void arm_std_q31(q31_t * pSrc, uint32_t blockSize, q31_t * pResult);
+
+/**
+ * @brief Root mean square
+ */
+void arm_rms_q15(q15_t * pSrc, uint32_t blockSize, q15_t * pResult);
+void arm_rms_q31(q31_t * pSrc, uint32_t blockSize, q31_t * pResult);
+
+/**
+ * @brief Convert between 1.15 and 1.31. Narrowing truncates, as the library does.
+ */
+void arm_q15_to_q31(q15_t * pSrc, q31_t * pDst, uint32_t blockSize);
+void arm_q31_to_q15(q31_t * pSrc, q15_t * pDst, uint32_t blockSize);
+
+/**
+ * @brief Cascade of direct form I biquads in 1.15.
+ *
+ * Coefficients are {b0, 0, b1, b2, a1, a2} per stage, the 0 padding the
+ * library's packed loads, and the feedback terms negated:
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2].
+ * Coefficients of magnitude 1 or more are scaled down by 2^postShift, which
+ * the output shift puts back. State is {x[n-1], x[n-2], y[n-1], y[n-2]} per
+ * stage. Products are summed in 64 bits and the output saturates.
+ */
+typedef struct
+{
+	int8_t numStages;
+	q15_t *pState;
+	q15_t *pCoeffs;
+	int8_t postShift;
+} arm_biquad_casd_df1_inst_q15;
+
+void arm_biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 * S, uint8_t numStages,
+		q15_t * pCoeffs, q15_t * pState, int8_t postShift);
+void arm_biquad_cascade_df1_q15(const arm_biquad_casd_df1_inst_q15 * S, q15_t * pSrc,
+		q15_t * pDst, uint32_t blockSize);
+
+/**
+ * @brief Cascade of direct form I biquads in 1.31.
+ *
+ * Coefficients are {b0, b1, b2, a1, a2} per stage, with no padding,
+ * otherwise as the 1.15 version. The output is truncated, not saturated.
+ */
+typedef struct
+{
+	uint32_t numStages;
+	q31_t *pState;
+	q31_t *pCoeffs;
+	uint8_t postShift;
+} arm_biquad_casd_df1_inst_q31;
+
+void arm_biquad_cascade_df1_init_q31(arm_biquad_casd_df1_inst_q31 * S, uint8_t numStages,
+		q31_t * pCoeffs, q31_t * pState, int8_t postShift);
+void arm_biquad_cascade_df1_q31(const arm_biquad_casd_df1_inst_q31 * S, q31_t * pSrc,
+		q31_t * pDst, uint32_t blockSize);
+
+/**
+ * @brief FIR filter in 1.15.
+ *
+ * Coefficients are in time-reversed order, {b[numTaps-1], ... b[0]}.
+ * The state holds numTaps + blockSize - 1 samples, the Cortex-M0 layout,
+ * and blockSize is the most samples passed to one call. The output
+ * saturates. The library wants an even numTaps of at least 4 on the
+ * M3 and M4, so keep to that.
+ */
+typedef struct
+{
+	uint16_t numTaps;
+	q15_t *pState;
+	q15_t *pCoeffs;
+} arm_fir_instance_q15;
+
+arm_status arm_fir_init_q15(arm_fir_instance_q15 * S, uint16_t numTaps, q15_t * pCoeffs,
+		q15_t * pState, uint32_t blockSize);
+void arm_fir_q15(const arm_fir_instance_q15 * S, q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+
+#endif
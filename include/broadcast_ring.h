@@ -0,0 +1,156 @@
+/*
+ * @file broadcast_ring.h
+ * @brief Project 6
+ *
+ * @details A single-writer ring of 16 bit samples read by several consumers.
+ *          Every reader has its own read index into the one copy of the data,
+ *          so adding a consumer costs a cursor rather than a buffer.
+ *
+ *          The writer keeps going as long as the slowest attached reader has
+ *          room. When it does not, the ring's cbuf_policy decides: with
+ *          cbuf_policy_reject the push fails (backpressure), with
+ *          cbuf_policy_overwrite the writer moves on and lagging readers
+ *          skip ahead to the oldest surviving sample, counting what they lost.
+ *
+ *          Like spsc_ring.h, each index is a free-running 32 bit counter with
+ *          one writer, so the writer and the readers can run in any mix of
+ *          ISRs and tasks without locks. Attach and detach readers from one
+ *          task while the writer is idle or running, but not concurrently
+ *          with each other.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef BROADCAST_RING_H
+#define BROADCAST_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "circular_buffer.h"
+#include "ring_stats.h"
+
+/**
+ * @brief Most readers one ring can have
+ */
+#ifndef BROADCAST_RING_MAX_READERS
+#define BROADCAST_RING_MAX_READERS (4)
+#endif
+
+/**
+ * @brief A run of samples in place in the ring
+ */
+typedef struct broadcast_span_t {
+	const uint16_t * data;
+	size_t count;
+} broadcast_span_t;
+
+/**
+ * @brief Broadcast ring. Storage is provided by the caller.
+ */
+typedef struct broadcast_ring_t {
+	uint16_t * buffer;
+	uint32_t mask;
+	cbuf_policy policy;
+	volatile uint32_t head;                                // next slot to write, writer owned
+	volatile uint32_t tails[BROADCAST_RING_MAX_READERS];   // next slot to read, reader owned
+	volatile uint32_t attached;                            // bit per attached reader
+	uint32_t lost[BROADCAST_RING_MAX_READERS];             // samples a reader was overrun by
+	uint32_t space;                                        // free slots last seen by the writer
+	uint32_t seenAttached;                                 // attached as of space, writer owned
+	RING_STATS_FIELD
+} broadcast_ring_t;
+
+/**
+ * @brief Initialize a broadcast ring with no readers
+ * @param outRing Ring to initialize
+ * @param inStorage Storage for inCapacity samples
+ * @param inCapacity Samples, a power of two, at least 2 with cbuf_policy_overwrite
+ * @param inPolicy What the writer does when the slowest reader is a full ring behind.
+ *                 With cbuf_policy_overwrite a lapped reader keeps capacity - 1
+ *                 samples, as the writer may be storing over the oldest.
+ * @return buff_err_invalid if the arguments are bad
+ */
+buff_err broadcast_ring_init(broadcast_ring_t* outRing, uint16_t* inStorage, size_t inCapacity,
+		                     cbuf_policy inPolicy);
+
+/**
+ * @brief Add a reader. It sees samples pushed from now on.
+ * @param inRing Ring to read
+ * @param outReader Reader id to pass to the read functions
+ * @return buff_err_full if BROADCAST_RING_MAX_READERS are attached
+ */
+buff_err broadcast_ring_attach(broadcast_ring_t* inRing, size_t* outReader);
+
+/**
+ * @brief Remove a reader so it no longer holds the writer back
+ * @param inRing Ring being read
+ * @param inReader Reader id from broadcast_ring_attach
+ */
+void broadcast_ring_detach(broadcast_ring_t* inRing, size_t inReader);
+
+/**
+ * @brief Writer side. Add a sample for every attached reader.
+ * @param inRing Ring to write
+ * @param inSample Sample to add
+ * @return buff_err_full if the slowest reader has no room. With
+ *         cbuf_policy_overwrite the sample is stored anyway.
+ */
+buff_err broadcast_ring_push(broadcast_ring_t* inRing, uint16_t inSample);
+
+/**
+ * @brief Reader side. Take the next sample for this reader.
+ * @param inRing Ring to read
+ * @param inReader Reader id
+ * @param outSample Sample read
+ * @return buff_err_empty if this reader is caught up
+ */
+buff_err broadcast_ring_pop(broadcast_ring_t* inRing, size_t inReader, uint16_t* outSample);
+
+/**
+ * @brief Reader side. Get this reader's unread samples in place.
+ * @param inRing Ring to read
+ * @param inReader Reader id
+ * @param outSpans Filled with up to two runs of samples
+ * @return Total samples in the spans
+ */
+size_t broadcast_ring_peek_read(broadcast_ring_t* inRing, size_t inReader,
+		                        broadcast_span_t outSpans[2]);
+
+/**
+ * @brief Reader side. Consume samples obtained from broadcast_ring_peek_read.
+ * @param inRing Ring to read
+ * @param inReader Reader id
+ * @param inCount Samples to consume
+ * @return buff_err_full if the writer overwrote part of what was peeked,
+ *         in which case the reader has been moved to the oldest valid sample.
+ */
+buff_err broadcast_ring_commit_read(broadcast_ring_t* inRing, size_t inReader, size_t inCount);
+
+/**
+ * @brief Unread samples for one reader
+ */
+size_t broadcast_ring_size(broadcast_ring_t* inRing, size_t inReader);
+
+/**
+ * @brief Unread samples for the slowest attached reader, 0 if none are attached
+ */
+size_t broadcast_ring_slowest(broadcast_ring_t* inRing);
+
+/**
+ * @brief Samples a reader has lost to overwrites since it attached
+ */
+uint32_t broadcast_ring_lost(broadcast_ring_t* inRing, size_t inReader);
+
+/**
+ * @brief Capacity in samples
+ */
+size_t broadcast_ring_capacity(broadcast_ring_t* inRing);
+
+#endif
@@ -20,7 +20,34 @@
 #ifndef CIRCULAR_BUFFER_H
 #define CIRCULAR_BUFFER_H
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
+#include "ring_stats.h"
+
+/**
+ * @brief Whether to validate buffer handles on every call
+ * @details Validation checks a magic word stored in the descriptor, so it costs
+ *          the same no matter how many buffers are live. Builds that define
+ *          NDEBUG (Release) compile the check out and only reject NULL handles.
+ *          Define as 0 or 1 to override.
+ */
+#ifndef CIRCULAR_BUF_CHECKS
+#ifdef NDEBUG
+#define CIRCULAR_BUF_CHECKS (0)
+#else
+#define CIRCULAR_BUF_CHECKS (1)
+#endif
+#endif
+
+/**
+ * @brief How many descriptors circular_buf_init_static can hand out.
+ * @details The pool lives in .bss, so static buffers need no heap at all.
+ *          The firmware uses none, so by default there is no pool and
+ *          circular_buf_init_static always returns NULL.
+ */
+#ifndef CIRCULAR_BUF_POOL_SIZE
+#define CIRCULAR_BUF_POOL_SIZE (0)
+#endif
 
 /**
  * @brief Buffer error codes.
@@ -32,15 +59,27 @@ typedef enum buff_err {
 	buff_err_invalid
 } buff_err;
 
+/**
+ * @brief What a push does when the buffer is full.
+ */
+typedef enum cbuf_policy {
+	cbuf_policy_overwrite, // drop the oldest element (default)
+	cbuf_policy_reject     // drop the new element
+} cbuf_policy;
+
 /**
  * @brief Opaque struct for circular buffer
  */
 typedef struct circular_buf_t {
+	uint32_t magic;
 	uint32_t * buffer;
 	size_t write;
 	size_t read;
 	size_t max;
 	bool full;
+	bool isStatic;
+	cbuf_policy policy;
+	RING_STATS_FIELD
 } circular_buf_t;
 
 /**
@@ -48,6 +87,16 @@ typedef struct circular_buf_t {
  */
 typedef circular_buf_t* cbuf_handle_t;
 
+/**
+ * @brief A contiguous region of buffer storage.
+ * @details The readable or writable part of a circular buffer is at most
+ *          two of these: up to the end of storage, then from the start.
+ */
+typedef struct cbuf_span_t {
+	uint32_t * data;
+	size_t count;
+} cbuf_span_t;
+
 /**
  * @brief Create a new buffer
  * @param inSize Capacity of the buffer
@@ -55,8 +104,20 @@ typedef circular_buf_t* cbuf_handle_t;
  */
 cbuf_handle_t circular_buf_init(size_t inSize);
 
+/**
+ * @brief Create a buffer over caller-provided storage without using the heap
+ * @details The descriptor comes from a fixed pool of CIRCULAR_BUF_POOL_SIZE.
+ *          Static buffers cannot be resized.
+ * @param inStorage Storage for inSize elements, e.g. a static array
+ * @param inSize Capacity of the buffer
+ * @return A circular buffer handle, or NULL if the pool is exhausted or empty
+ */
+cbuf_handle_t circular_buf_init_static(uint32_t * inStorage, size_t inSize);
+
 /**
  * @brief Free a circular buffer and all associated heap memory
+ * @details Static buffers return their descriptor to the pool. The caller
+ *          keeps ownership of the storage.
  * @param inBufHandle Handle to the buffer to free
  */
 void circular_buf_free(cbuf_handle_t inBufHandle);
@@ -69,11 +130,20 @@ void circular_buf_free(cbuf_handle_t inBufHandle);
  */
 buff_err circular_buf_resize(cbuf_handle_t* inOutBufHandle, size_t inSize);
 
+/**
+ * @brief Choose what circular_buf_push does when the buffer is full
+ * @param inBufHandle The buffer to configure
+ * @param inPolicy Overwrite the oldest element, or reject the new one
+ */
+void circular_buf_set_policy(cbuf_handle_t inBufHandle, cbuf_policy inPolicy);
+
 /**
  * @brief Push a new element into the circular buffer
  * @param inBufHandle Buffer to push to
  * @param inData Data to push into the buffer
- * @return Whether the operation succeeded. Errors if not.
+ * @return Whether the operation succeeded. buff_err_full if the buffer was
+ *         full, in which case the oldest or the new element was dropped
+ *         according to the buffer's policy.
  */
 buff_err circular_buf_push(cbuf_handle_t inBufHandle, uint32_t inData);
 
@@ -93,6 +163,63 @@ buff_err circular_buf_push_resize(cbuf_handle_t* inOutBufHandle, uint32_t inData
  */
 buff_err circular_buf_pop(cbuf_handle_t inBufHandle, uint32_t * outData);
 
+/**
+ * @brief Push several elements with at most two memcpy calls
+ * @details Unlike circular_buf_push this never overwrites unread data.
+ * @param inBufHandle Buffer to push to
+ * @param inData Data to push
+ * @param inCount Number of elements in inData
+ * @param outCount Number of elements actually pushed. May be NULL.
+ * @return buff_err_full if not everything fit
+ */
+buff_err circular_buf_push_n(cbuf_handle_t inBufHandle, const uint32_t * inData,
+		                     size_t inCount, size_t * outCount);
+
+/**
+ * @brief Pop several elements with at most two memcpy calls
+ * @param inBufHandle Buffer to pop from
+ * @param outData Where to copy the popped elements
+ * @param inCount Most elements to pop
+ * @param outCount Number of elements actually popped. May be NULL.
+ * @return buff_err_empty if nothing was popped
+ */
+buff_err circular_buf_pop_n(cbuf_handle_t inBufHandle, uint32_t * outData,
+		                    size_t inCount, size_t * outCount);
+
+/**
+ * @brief Get the readable region in place, without consuming it
+ * @param inBufHandle The buffer to read
+ * @param outSpans Filled with up to two spans, oldest data first.
+ *                 Unused spans have a count of 0.
+ * @return Total number of readable elements
+ */
+size_t circular_buf_peek_read(cbuf_handle_t inBufHandle, cbuf_span_t outSpans[2]);
+
+/**
+ * @brief Consume elements previously returned by circular_buf_peek_read
+ * @param inBufHandle The buffer to consume from
+ * @param inCount Number of elements to consume
+ * @return buff_err_invalid if more than the readable count
+ */
+buff_err circular_buf_commit_read(cbuf_handle_t inBufHandle, size_t inCount);
+
+/**
+ * @brief Get the free region in place, to be filled by the caller (e.g. by DMA)
+ * @param inBufHandle The buffer to write
+ * @param outSpans Filled with up to two spans, in write order.
+ *                 Unused spans have a count of 0.
+ * @return Total number of writable elements
+ */
+size_t circular_buf_peek_write(cbuf_handle_t inBufHandle, cbuf_span_t outSpans[2]);
+
+/**
+ * @brief Publish elements written into the spans from circular_buf_peek_write
+ * @param inBufHandle The buffer written to
+ * @param inCount Number of elements written
+ * @return buff_err_invalid if more than the writable count
+ */
+buff_err circular_buf_commit_write(cbuf_handle_t inBufHandle, size_t inCount);
+
 /**
  * @brief Return whether the buffer is empty
  * @param inBufHandle The buffer to check
@@ -0,0 +1,81 @@
+/*
+ * @file const_trig.h
+ * @brief Project 6
+ *
+ * @details Sine and cosine as arithmetic constant expressions, for tables
+ *          and coefficients that the compiler folds to integers.
+ *
+ *          A static initializer may not call sin(), but it may do floating
+ *          arithmetic and cast the result to an integer. These macros expand
+ *          to such arithmetic, so their results land in flash and nothing
+ *          is computed or linked from libm at run time. Sine comes from its
+ *          Taylor series up to x^11 in Horner form, which is within 6e-8 on
+ *          [-pi/2, pi/2]; angles are folded into that range first.
+ *
+ *          Arguments are expanded many times over, so pass constants only.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef CONST_TRIG_H
+#define CONST_TRIG_H
+
+#include <stdint.h>
+
+#define CONST_TRIG_PI 3.14159265358979323846
+
+/**
+ * @brief sin(x) for x in [-pi/2, pi/2]
+ */
+#define CONST_TRIG_TAYLOR_SIN(x) ((x) * (1.0 - (x) * (x) / 6.0 * (1.0 - (x) * (x) / 20.0 * \
+                                 (1.0 - (x) * (x) / 42.0 * (1.0 - (x) * (x) / 72.0 * \
+                                 (1.0 - (x) * (x) / 110.0))))))
+
+/**
+ * @brief sin and cos of an angle in [0, pi]
+ */
+#define CONST_TRIG_SIN_HALF(t) CONST_TRIG_TAYLOR_SIN(((t) > CONST_TRIG_PI / 2.0) ? CONST_TRIG_PI - (t) : (t))
+#define CONST_TRIG_COS_HALF(t) CONST_TRIG_TAYLOR_SIN(CONST_TRIG_PI / 2.0 - (t))
+
+/**
+ * @brief sin and cos of an angle in [0, 2 pi)
+ */
+#define CONST_TRIG_SIN(t) (((t) > CONST_TRIG_PI) ? -CONST_TRIG_SIN_HALF((t) - CONST_TRIG_PI) : \
+                                                   CONST_TRIG_SIN_HALF(t))
+#define CONST_TRIG_COS(t) (((t) > CONST_TRIG_PI) ? -CONST_TRIG_COS_HALF((t) - CONST_TRIG_PI) : \
+                                                   CONST_TRIG_COS_HALF(t))
+
+/**
+ * @brief Angle of step inStep of inSteps around the circle, in [0, 2 pi)
+ *        when inStep < inSteps
+ */
+#define CONST_TRIG_ANGLE(inStep, inSteps) (2.0 * CONST_TRIG_PI * (double)(inStep) / (double)(inSteps))
+
+/**
+ * @brief Round a value in [-1, 1] to 1.15, with 1.0 as 0x7FFF like the CMSIS tables
+ */
+#define CONST_TRIG_Q15(v) ((int16_t)((v) * 32767.0 + (((v) < 0.0) ? -0.5 : 0.5)))
+
+/**
+ * @brief CONST_TRIG_REPEAT_n(m, k) expands m(k), m(k + 1), ... m(k + n - 1),
+ *        to fill a table. m supplies the separating commas.
+ */
+#define CONST_TRIG_REPEAT_1(m, k)    m(k)
+#define CONST_TRIG_REPEAT_2(m, k)    CONST_TRIG_REPEAT_1(m, k)   CONST_TRIG_REPEAT_1(m, (k) + 1)
+#define CONST_TRIG_REPEAT_4(m, k)    CONST_TRIG_REPEAT_2(m, k)   CONST_TRIG_REPEAT_2(m, (k) + 2)
+#define CONST_TRIG_REPEAT_8(m, k)    CONST_TRIG_REPEAT_4(m, k)   CONST_TRIG_REPEAT_4(m, (k) + 4)
+#define CONST_TRIG_REPEAT_16(m, k)   CONST_TRIG_REPEAT_8(m, k)   CONST_TRIG_REPEAT_8(m, (k) + 8)
+#define CONST_TRIG_REPEAT_32(m, k)   CONST_TRIG_REPEAT_16(m, k)  CONST_TRIG_REPEAT_16(m, (k) + 16)
+#define CONST_TRIG_REPEAT_64(m, k)   CONST_TRIG_REPEAT_32(m, k)  CONST_TRIG_REPEAT_32(m, (k) + 32)
+#define CONST_TRIG_REPEAT_128(m, k)  CONST_TRIG_REPEAT_64(m, k)  CONST_TRIG_REPEAT_64(m, (k) + 64)
+#define CONST_TRIG_REPEAT_256(m, k)  CONST_TRIG_REPEAT_128(m, k) CONST_TRIG_REPEAT_128(m, (k) + 128)
+#define CONST_TRIG_REPEAT_512(m, k)  CONST_TRIG_REPEAT_256(m, k) CONST_TRIG_REPEAT_256(m, (k) + 256)
+#define CONST_TRIG_REPEAT_1024(m, k) CONST_TRIG_REPEAT_512(m, k) CONST_TRIG_REPEAT_512(m, (k) + 512)
+
+#endif
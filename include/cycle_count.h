@@ -0,0 +1,34 @@
+/*
+ * @file cycle_count.h
+ * @brief Project 6
+ *
+ * @details A free-running CPU cycle counter for profiling on the KL25Z.
+ *          The Cortex-M0+ has no DWT cycle counter, so this combines the
+ *          FreeRTOS tick count with the SysTick down counter.
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef __cyclecounth__
+#define __cyclecounth__
+
+#include <stdint.h>
+
+/**
+ * Current cycle count. Wraps about every 89 seconds at 48 MHz, so only
+ * differences between two nearby readings are meaningful.
+ * Call from task context only.
+ */
+uint32_t cycle_count_now();
+
+/**
+ * Convert a cycle count difference to microseconds.
+ */
+uint32_t cycle_count_to_us(uint32_t inCycles);
+
+#endif
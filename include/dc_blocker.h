@@ -0,0 +1,65 @@
+/*
+ * @file dc_blocker.h
+ * @brief Project 6
+ *
+ * @details DC blocking filter on 1.15 blocks, in place:
+ *          y[n] = x[n] - x[n-1] + pole y[n-1].
+ *
+ *          A zero at DC and a pole just inside it take out the offset and
+ *          little else; the cutoff is about (1 - pole) fs / (2 pi). The
+ *          rounding error of each output is fed into the next, so the
+ *          quantization noise has a zero at DC too and the output settles to
+ *          a mean of exactly zero rather than a fraction of an LSB off it.
+ *
+ *          The CMSIS-DSP library has no such kernel, so it lives here.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef DC_BLOCKER_H
+#define DC_BLOCKER_H
+
+#include <stdint.h>
+#include "dsp_stats.h"
+
+/**
+ * @brief Filter state, carried from one block to the next
+ */
+typedef struct dc_blocker_t {
+	q15_t pole;       // 1.15, just below 1
+	q15_t offset;     // added to every output, to keep it in range of the input
+	q15_t x1;         // last input
+	int32_t y1;       // last output, before the offset; can reach 2^15
+	int32_t error;    // rounding error of the last output, 15 fractional bits
+} dc_blocker_t;
+
+/**
+ * @brief Set up a blocker with no history
+ * @param inPole 1.15 pole, e.g. 0.99 for a cutoff of fs / 630
+ * @param inOffset Added to every output. Half the input range keeps
+ *        unsigned codes unsigned; 0 leaves the output centred on zero.
+ */
+void dc_blocker_init(dc_blocker_t* inBlocker, q15_t inPole, q15_t inOffset);
+
+/**
+ * @brief Set the history as if the input had always been inSample
+ * @details Without it the first output is about inSample + offset, which
+ *          takes the time constant of the pole to decay.
+ */
+void dc_blocker_prime(dc_blocker_t* inBlocker, q15_t inSample);
+
+/**
+ * @brief Filter a block in place
+ *
+ * Inputs must stay within +/-2^14, so successive differences fit in 1.15:
+ * 12 bit codes with room to spare. Outputs saturate.
+ */
+void dc_blocker_q15(dc_blocker_t* inBlocker, q15_t* ioBlock, uint32_t inCount);
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * @file decimator.h
+ * @brief Project 6
+ *
+ * @details Oversample-and-decimate front end for ADC0: a CIC decimator
+ *          followed by a short FIR that flattens the CIC's passband.
+ *
+ *          With ADC_OVERSAMPLE_RATIO R above 1, read_adc0_task reads the ADC
+ *          R times per report period and this turns every R conversions into
+ *          one sample at the report rate. The CIC is DECIMATOR_CIC_ORDER
+ *          integrators at the input rate and as many combs at the output
+ *          rate: no multiplies, and unsigned wraparound is harmless as long
+ *          as the true output fits 32 bits, which 12 bit codes do up to
+ *          R = 2^(20 / order). The CIC's sinc^order response droops
+ *          toward the output Nyquist frequency; the compensator,
+ *          {-a, 1 + 2a, -a} with a = order / 24, is its inverse to
+ *          second order in frequency.
+ *
+ *          Effective bits gained, for white noise of at least about an LSB,
+ *          as on an undithered 12 bit converter, are half a bit per doubling
+ *          of R, since averaging R samples cuts the noise power by R:
+ *
+ *              R        4     10     16     25     50    100
+ *              bits   +1.0  +1.7   +2.0   +2.3   +2.8   +3.3
+ *
+ *          Noise that is correlated between conversions, or a quiet input
+ *          that always reads the same code, gains nothing. Outputs carry
+ *          DECIMATOR_FRACTION_BITS below the ADC code, to hold those bits.
+ *
+ *          On target those bits are not kept: read_adc0_task rounds every
+ *          output back to a 12 bit code with decimator_to_code before the
+ *          sliding window, the trigger and the DSP blocks see it, and the
+ *          reports are in whole millivolts, about 1.25 codes. A target build
+ *          gains noise reduction, not resolution.
+ *
+ *          The conversions are paced by the FreeRTOS software timer, whose
+ *          period is pdMS_TO_TICKS(100 / ADC_OVERSAMPLE_RATIO). With 1 ms
+ *          ticks that is at most 1 kHz of timer callbacks, so the ratio must
+ *          divide the 100 ms report period: 2, 4, 5, 10, 20, 25, 50 or 100.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief ADC conversions per reported sample. 1 reads once per period, as before.
+ */
+#ifndef ADC_OVERSAMPLE_RATIO
+#define ADC_OVERSAMPLE_RATIO 1
+#endif
+
+/**
+ * @brief Integrator and comb pairs in the CIC, 1 to 3
+ */
+#ifndef DECIMATOR_CIC_ORDER
+#define DECIMATOR_CIC_ORDER 3
+#endif
+
+/**
+ * @brief Fractional bits of an output below the 12 bit ADC code
+ */
+#define DECIMATOR_FRACTION_BITS 4
+
+/**
+ * @brief Largest ratio whose CIC output still fits 32 bits
+ */
+#define DECIMATOR_MAX_RATIO (DECIMATOR_CIC_ORDER == 1 ? 1048576u : \
+                             (DECIMATOR_CIC_ORDER == 2 ? 1024u : 101u))
+
+#if DECIMATOR_CIC_ORDER < 1 || DECIMATOR_CIC_ORDER > 3
+#error "DECIMATOR_CIC_ORDER must be 1, 2 or 3"
+#endif
+
+/**
+ * @brief Decimator state
+ */
+typedef struct decimator_t {
+	uint32_t integrators[DECIMATOR_CIC_ORDER];
+	uint32_t combs[DECIMATOR_CIC_ORDER];    // each comb's last input
+	uint32_t gain;                          // ratio^order
+	uint32_t ratio;
+	uint32_t phase;                         // inputs since the last output
+	int32_t history[2];                     // last two CIC outputs, scaled
+} decimator_t;
+
+/**
+ * @brief Set up a decimator with no history
+ * @param inRatio Inputs per output, 1 to DECIMATOR_MAX_RATIO
+ * @return buff_err_invalid on a null decimator or a ratio out of range
+ */
+buff_err decimator_init(decimator_t* inDecimator, uint32_t inRatio);
+
+/**
+ * @brief Take one ADC code
+ * @param inCode 12 bit code
+ * @param outSample Set when this input completes an output: the code with
+ *        DECIMATOR_FRACTION_BITS fractional bits, saturated to 16 bits
+ * @return Whether outSample was set
+ *
+ * The CIC and the compensator together delay the signal by
+ * (order (ratio - 1) / 2) inputs plus one output.
+ */
+bool decimator_push(decimator_t* inDecimator, uint16_t inCode, uint16_t* outSample);
+
+/**
+ * @brief An output rounded back to a 12 bit code
+ */
+static inline uint16_t decimator_to_code(uint16_t inSample)
+{
+	uint32_t code = ((uint32_t)inSample + (1u << (DECIMATOR_FRACTION_BITS - 1))) >> DECIMATOR_FRACTION_BITS;
+	return code > 4095u ? 4095u : (uint16_t)code;
+}
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * @file dsp_stats.h
+ * @brief Project 6
+ *
+ * @details Block statistics on the DSP buffer through the CMSIS-DSP
+ *          statistics kernels (arm_min/max/mean/std/rms_q15).
+ *
+ *          The 12 bit ADC codes are non-negative 1.15 values as they are, so
+ *          the kernels run on the block in place with no conversion. The block
+ *          is first scaled up to use the spare high bits, which keeps the
+ *          variance from vanishing in the kernels' 1.15 intermediate.
+ *          arm_std_q15 divides by n - 1; its result is rescaled to the
+ *          population value, so both paths report the same quantity.
+ *
+ *          Two build-time switches:
+ *          DSP_STATS_USE_CMSIS      dsp_callback reports block statistics from
+ *                                   these kernels instead of the hand-written
+ *                                   stream_stats path.
+ *          DSP_STATS_CMSIS_LIBRARY  link the real CMSIS-DSP library (define
+ *                                   ARM_MATH_CM0PLUS and add arm_cortexM0l_math)
+ *                                   instead of the portable arm_math_ref.c.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef DSP_STATS_H
+#define DSP_STATS_H
+
+#include <stdint.h>
+
+/**
+ * @brief Whether dsp_callback uses the CMSIS-DSP kernels for block statistics
+ */
+#ifndef DSP_STATS_USE_CMSIS
+#define DSP_STATS_USE_CMSIS (0)
+#endif
+
+/**
+ * @brief Whether the kernels come from the CMSIS-DSP library or arm_math_ref.c
+ */
+#ifndef DSP_STATS_CMSIS_LIBRARY
+#define DSP_STATS_CMSIS_LIBRARY (0)
+#endif
+
+#if DSP_STATS_CMSIS_LIBRARY
+#include "arm_math.h"
+#else
+#include "arm_math_ref.h"
+#endif
+
+/**
+ * @brief Bits of headroom above 12 bit ADC codes in a 1.15 value
+ */
+#define DSP_STATS_ADC_HEADROOM (3u)
+
+/**
+ * @brief Statistics of one block, in the units of the input samples
+ */
+typedef struct dsp_block_stats_t {
+	q15_t min;
+	q15_t max;
+	q15_t mean;
+	q15_t stdDev;      // population standard deviation, as stream_stats
+	q15_t rms;
+	uint32_t minIndex;
+	uint32_t maxIndex;
+} dsp_block_stats_t;
+
+/**
+ * @brief Run the statistics kernels over a block
+ * @param inOutBlock Samples. Scaled in place by inHeadroomBits, so the caller
+ *        must own the block and not need the original values afterwards.
+ * @param inCount Samples in the block, at least 1
+ * @param inHeadroomBits Left shift that still fits every sample in 1.15
+ * @param outStats Results, scaled back to the input units
+ */
+void dsp_block_stats_q15(q15_t* inOutBlock, uint32_t inCount, uint32_t inHeadroomBits,
+		                 dsp_block_stats_t* outStats);
+
+#endif
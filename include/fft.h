@@ -0,0 +1,112 @@
+/*
+ * @file fft.h
+ * @brief Project 6
+ *
+ * @details Fixed-point (1.15) radix-2 FFT over one DSP block, and a spectrum
+ *          report for the DAC0 to ADC0 loopback: fundamental frequency,
+ *          amplitude, DC offset and total harmonic distortion.
+ *
+ *          The transform is in place over interleaved complex samples and
+ *          halves every stage, so it cannot overflow and bin k holds
+ *          X[k] / FFT_SIZE. Twiddle factors and the Hann window are tables
+ *          computed by the compiler, so they live in flash and cost nothing
+ *          at run time.
+ *
+ *          The size is fixed at build time by FFT_LOG2_SIZE (2 to 10). The
+ *          analysis needs a block to hold several cycles of the tone: within
+ *          2 * FFT_LOBE_BINS bins of DC the tone overlaps its own image and
+ *          its second harmonic, so it is refused rather than misreported.
+ *          At the shipped 10 Hz rate a 64 sample block holds 1.28 cycles of
+ *          the 50 sample sine, which is why the report is off by default.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdint.h>
+#include "circular_buffer.h"
+#include "dsp_stats.h"
+
+/**
+ * @brief Whether dsp_callback reports the spectrum of each block
+ */
+#ifndef DSP_FFT_ANALYSIS
+#define DSP_FFT_ANALYSIS (0)
+#endif
+
+/**
+ * @brief log2 of the transform size
+ */
+#ifndef FFT_LOG2_SIZE
+#define FFT_LOG2_SIZE 6
+#endif
+
+#if FFT_LOG2_SIZE < 2 || FFT_LOG2_SIZE > 10
+#error "FFT_LOG2_SIZE must be between 2 and 10"
+#endif
+
+/**
+ * @brief Points in the transform
+ */
+#define FFT_SIZE (1u << FFT_LOG2_SIZE)
+
+/**
+ * @brief q15_t elements of work storage: FFT_SIZE interleaved complex samples
+ */
+#define FFT_WORK_LENGTH (2u * FFT_SIZE)
+
+/**
+ * @brief Bins summed either side of a tone. The Hann main lobe is 2 bins wide each way.
+ */
+#define FFT_LOBE_BINS 2u
+
+/**
+ * @brief Highest harmonic counted in the THD
+ */
+#ifndef FFT_THD_MAX_HARMONIC
+#define FFT_THD_MAX_HARMONIC 10
+#endif
+
+/**
+ * @brief Spectrum report of one block
+ */
+typedef struct fft_analysis_t {
+	uint32_t peakBin;            // strongest bin above DC, 0 if the block is flat
+	uint32_t fundamentalMilliHz; // interpolated between bins
+	uint32_t amplitude;          // peak amplitude of the fundamental, in ADC codes
+	uint32_t dcOffset;           // block mean, in ADC codes
+	uint32_t thdPpm;             // harmonics below Nyquist over the fundamental, RMS
+} fft_analysis_t;
+
+/**
+ * @brief In-place FFT, scaled by 1 / FFT_SIZE
+ * @param inOutData FFT_SIZE complex samples as {re, im} pairs, in natural
+ *        order. Replaced by the spectrum, also in natural order. Magnitudes
+ *        must not exceed 1.0 (every component within +-23170 is enough).
+ */
+void fft_q15(q15_t* inOutData);
+
+/**
+ * @brief Spectrum report of one block of ADC codes
+ * @param inBlock FFT_SIZE 12 bit codes
+ * @param inCount Samples in the block, must be FFT_SIZE
+ * @param inSampleRateMilliHz Rate the block was sampled at
+ * @param inWork FFT_WORK_LENGTH elements of scratch
+ * @param outAnalysis Results
+ * @return buff_err_invalid on a size mismatch or null argument, and when the
+ *         tone is at most 2 * FFT_LOBE_BINS bins above DC. Then only peakBin
+ *         and dcOffset are filled in.
+ */
+buff_err fft_analyze_block_u16(const uint16_t* inBlock, uint32_t inCount,
+		                       uint32_t inSampleRateMilliHz, q15_t* inWork,
+		                       fft_analysis_t* outAnalysis);
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * @file filter_chain.h
+ * @brief Project 6
+ *
+ * @details Fixed-point filters run on each ADC block in place, before the
+ *          statistics. Each stage has its own build-time switch, and a stage
+ *          that is off is not compiled, so it costs no code, RAM or cycles:
+ *
+ *          FILTER_CHAIN_DC_BLOCK    DC blocker, pole 0.99 (cutoff ~16 mHz at
+ *                                   10 Hz), output centred on mid-scale
+ *          FILTER_CHAIN_BIQUAD_Q15  2nd order Butterworth lowpass at fs / 10,
+ *                                   direct form I in 1.15
+ *          FILTER_CHAIN_BIQUAD_Q31  2nd order Butterworth lowpass at fs / 20,
+ *                                   direct form I in 1.31, where the poles
+ *                                   are too close to DC for 1.15 coefficients
+ *          FILTER_CHAIN_FIR         8 tap Hamming windowed lowpass at fs / 8
+ *
+ *          Stages run in that order. The biquads and FIR are the CMSIS-DSP
+ *          kernels, from the library or arm_math_ref.c as DSP_STATS_CMSIS_LIBRARY
+ *          selects. Every stage has unity gain at DC, so block statistics stay
+ *          in millivolts, except that the DC blocker moves the mean to
+ *          mid-scale, and with it the offset that adc_quality.h reports.
+ *
+ *          Each stage's cycles are counted on the target, and
+ *          filter_chain_log reports them per sample.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef FILTER_CHAIN_H
+#define FILTER_CHAIN_H
+
+#include <stdint.h>
+#include "dsp_stats.h"
+
+/**
+ * @brief Which stages are built
+ */
+#ifndef FILTER_CHAIN_DC_BLOCK
+#define FILTER_CHAIN_DC_BLOCK (0)
+#endif
+
+#ifndef FILTER_CHAIN_BIQUAD_Q15
+#define FILTER_CHAIN_BIQUAD_Q15 (0)
+#endif
+
+#ifndef FILTER_CHAIN_BIQUAD_Q31
+#define FILTER_CHAIN_BIQUAD_Q31 (0)
+#endif
+
+#ifndef FILTER_CHAIN_FIR
+#define FILTER_CHAIN_FIR (0)
+#endif
+
+/**
+ * @brief Number of stages built. With none, dsp_callback skips the chain.
+ */
+#define FILTER_CHAIN_STAGES (FILTER_CHAIN_DC_BLOCK + FILTER_CHAIN_BIQUAD_Q15 + \
+                             FILTER_CHAIN_BIQUAD_Q31 + FILTER_CHAIN_FIR)
+
+/**
+ * @brief Most samples in one block, which sizes the FIR state and the
+ *        1.31 scratch for the Q31 biquad
+ */
+#ifndef FILTER_CHAIN_MAX_BLOCK
+#define FILTER_CHAIN_MAX_BLOCK 64
+#endif
+
+/**
+ * @brief Clear the state of every stage
+ * @details The next block starts every stage as if its input had always
+ *          been at the level of the first sample that reaches it.
+ */
+void filter_chain_init();
+
+/**
+ * @brief Run every stage over a block in place
+ * @param ioBlock Samples; 12 bit codes are valid 1.15 input as they are.
+ *        Filtered samples are clamped to 12 bit codes.
+ * @param inCount Samples in the block, at most FILTER_CHAIN_MAX_BLOCK
+ * @return Cycles the whole chain took
+ *
+ * Call from task context only, as for cycle_count_now.
+ */
+uint32_t filter_chain_process(q15_t* ioBlock, uint32_t inCount);
+
+/**
+ * @brief Log the cycles per sample of each stage so far
+ */
+void filter_chain_log();
+
+#endif
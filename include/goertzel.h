@@ -0,0 +1,103 @@
+/*
+ * @file goertzel.h
+ * @brief Project 6
+ *
+ * @details Goertzel single-tone detector: amplitude and phase of a block at
+ *          one or a few known frequencies, in integer arithmetic.
+ *
+ *          Each target costs one multiply-accumulate per sample, against
+ *          the full spectrum from fft.h, so it suits checking the known DAC
+ *          stimulus on every block. Targets are built at compile time with
+ *          GOERTZEL_TARGET, which folds their coefficients from const_trig.h.
+ *
+ *          A target is exact at any frequency, not only on FFT bins, but a
+ *          tone only reads at its full amplitude with no leakage from the
+ *          others when the block holds a whole number of its cycles.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef GOERTZEL_H
+#define GOERTZEL_H
+
+#include <stdint.h>
+#include "circular_buffer.h"
+#include "const_trig.h"
+
+/**
+ * @brief Whether dsp_callback measures the DAC stimulus on every block
+ */
+#ifndef DSP_GOERTZEL_ANALYSIS
+#define DSP_GOERTZEL_ANALYSIS (1)
+#endif
+
+/**
+ * @brief A frequency to measure over blocks of a fixed length
+ */
+typedef struct goertzel_target_t {
+	int32_t coeff;      // 2 cos(w), 2.30
+	int32_t cosW;       // cos(w), 1.30
+	int32_t sinW;       // sin(w), 1.30
+	int16_t cosEnd;     // cos(w (length - 1)), 1.15, to refer the phase to the first sample
+	int16_t sinEnd;
+	uint32_t length;    // samples per block
+} goertzel_target_t;
+
+/**
+ * @brief Round a value in [-2, 2) to 2.30
+ */
+#define GOERTZEL_Q30(v) ((int32_t)((v) * 1073741824.0 + (((v) < 0.0) ? -0.5 : 0.5)))
+
+/**
+ * @brief Target at inCycles cycles every inPeriod samples, over inLength
+ *        samples, as a constant initializer. All three must be integer
+ *        constants, with 0 < inCycles < inPeriod.
+ */
+#define GOERTZEL_TARGET(inCycles, inPeriod, inLength) { \
+	GOERTZEL_Q30(2.0 * CONST_TRIG_COS(CONST_TRIG_ANGLE(inCycles, inPeriod))), \
+	GOERTZEL_Q30(CONST_TRIG_COS(CONST_TRIG_ANGLE(inCycles, inPeriod))), \
+	GOERTZEL_Q30(CONST_TRIG_SIN(CONST_TRIG_ANGLE(inCycles, inPeriod))), \
+	CONST_TRIG_Q15(CONST_TRIG_COS(CONST_TRIG_ANGLE(((inCycles) * ((inLength) - 1)) % (inPeriod), inPeriod))), \
+	CONST_TRIG_Q15(CONST_TRIG_SIN(CONST_TRIG_ANGLE(((inCycles) * ((inLength) - 1)) % (inPeriod), inPeriod))), \
+	(inLength) }
+
+/**
+ * @brief One target's tone, as inAmplitude * cos(w n + phase) from the first sample
+ */
+typedef struct goertzel_result_t {
+	uint32_t amplitude;      // peak, in input units (ADC codes)
+	int32_t phaseCentiDeg;   // -18000 to 18000
+} goertzel_result_t;
+
+/**
+ * @brief Measure several targets over one block
+ * @param inBlock Samples. Each target reads its first length samples.
+ * @param inCount Samples in the block
+ * @param inOffset Subtracted from every sample, normally the block mean.
+ *        Keeps the filter state small; it does not change the result.
+ * @param inTargets Targets, all with length <= inCount
+ * @param inTargetCount Number of targets
+ * @param outResults One result per target
+ * @return buff_err_invalid on a null argument or a target longer than the block
+ *
+ * The filter state is kept within 2^30, which holds while
+ * 16 length * max|sample - inOffset| / |sin(w)| stays below that: any
+ * block of 12 bit codes up to 256 samples, for w above 1/20 rad.
+ */
+buff_err goertzel_block_u16(const uint16_t* inBlock, uint32_t inCount, int32_t inOffset,
+		                    const goertzel_target_t* inTargets, uint32_t inTargetCount,
+		                    goertzel_result_t* outResults);
+
+/**
+ * @brief Angle of (inX, inY) in hundredths of a degree, -18000 to 18000.
+ *        Within 0.01 degree; 0 for the origin.
+ */
+int32_t goertzel_atan2_centideg(int64_t inY, int64_t inX);
+
+#endif
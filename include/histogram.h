@@ -0,0 +1,113 @@
+/*
+ * @file histogram.h
+ * @brief Project 6
+ *
+ * @details Compact histogram of ADC codes with percentile queries.
+ *          Bins are a power of two codes wide, so binning is a shift.
+ *          Counts are 16 bit; when one would overflow, every bin is halved
+ *          and each count stands for twice as many samples from then on,
+ *          so a lifetime histogram never needs more memory. Fractions of a
+ *          count are rounded at random, which keeps the counts unbiased.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief Whether dsp_callback reports percentiles of each block and since boot
+ */
+#ifndef DSP_HISTOGRAM_ANALYSIS
+#define DSP_HISTOGRAM_ANALYSIS (1)
+#endif
+
+/**
+ * @brief Bits in the codes being binned. Larger codes land in the last bin.
+ */
+#define HISTOGRAM_CODE_BITS (12u)
+
+/**
+ * @brief Bin width as a power of two codes. 5 gives 32 codes, about 26 mV.
+ */
+#ifndef HISTOGRAM_BIN_SHIFT
+#define HISTOGRAM_BIN_SHIFT (5u)
+#endif
+
+#define HISTOGRAM_BIN_WIDTH (1u << HISTOGRAM_BIN_SHIFT)
+#define HISTOGRAM_BINS (1u << (HISTOGRAM_CODE_BITS - HISTOGRAM_BIN_SHIFT))
+
+/**
+ * @brief Largest count a bin holds before the histogram is halved
+ */
+#define HISTOGRAM_MAX_COUNT (0xFFFFu)
+
+#if HISTOGRAM_BIN_SHIFT > HISTOGRAM_CODE_BITS || HISTOGRAM_BINS * 2 + 12 >= 512
+#error "a histogram must fit in 512 bytes: HISTOGRAM_BIN_SHIFT of at least 5"
+#endif
+
+/**
+ * @brief Histogram of codes. Each count stands for 2^halvings samples.
+ */
+typedef struct histogram_t {
+	uint16_t bins[HISTOGRAM_BINS];
+	uint32_t total;    // sum of the bins
+	uint32_t halvings;
+	uint32_t dither;   // state of the random rounding
+} histogram_t;
+
+/**
+ * @brief Empty a histogram
+ * @param outHistogram Histogram to reset
+ */
+void histogram_reset(histogram_t* outHistogram);
+
+/**
+ * @brief Add a block of unsigned 16 bit samples, e.g. raw ADC codes
+ * @param inHistogram Histogram to update
+ * @param inSamples Samples to add
+ * @param inCount Number of samples
+ */
+void histogram_add_block_u16(histogram_t* inHistogram, const uint16_t* inSamples, uint32_t inCount);
+
+/**
+ * @brief Fold one histogram into another, e.g. a finished block into the
+ *        lifetime histogram. O(bins).
+ * @details The one halved fewer times is brought to the other's halvings,
+ *          and the total is halved again if a bin would overflow. Exact
+ *          while neither has been halved.
+ * @param inOutTotal Histogram to add to
+ * @param inHistogram Histogram to add
+ */
+void histogram_merge(histogram_t* inOutTotal, const histogram_t* inHistogram);
+
+/**
+ * @brief Code below which a given share of the samples lie
+ * @details Nearest rank, interpolated linearly inside its bin, so the
+ *          result is within one bin width of the exact percentile.
+ * @param inHistogram Histogram to read
+ * @param inCentiPercent Share in hundredths of a percent, e.g. 9900 for p99
+ * @param outCode The code
+ * @return buff_err_empty for an empty histogram, buff_err_invalid for a
+ *         share above 100 %
+ */
+buff_err histogram_percentile(const histogram_t* inHistogram, uint32_t inCentiPercent, uint16_t* outCode);
+
+/**
+ * @brief Samples the histogram stands for, up to the rounding of halving
+ */
+static inline uint64_t histogram_samples(const histogram_t* inHistogram)
+{
+	return inHistogram->halvings > 40 ? UINT64_MAX : (uint64_t)inHistogram->total << inHistogram->halvings;
+}
+
+#endif
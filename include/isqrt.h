@@ -0,0 +1,36 @@
+/*
+ * @file isqrt.h
+ * @brief Project 6
+ *
+ * @details Integer square roots. Digit-by-digit, so they only shift,
+ *          add and compare: no multiply, divide or soft-float call.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef ISQRT_H
+#define ISQRT_H
+
+#include <stdint.h>
+
+/**
+ * @brief Square root, rounded down
+ * @param inValue Value to take the root of
+ * @return floor(sqrt(inValue))
+ */
+uint32_t isqrt32(uint32_t inValue);
+
+/**
+ * @brief Square root, rounded down. Uses the 32 bit version when the value fits.
+ * @param inValue Value to take the root of
+ * @return floor(sqrt(inValue))
+ */
+uint32_t isqrt64(uint64_t inValue);
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * @file pingpong.h
+ * @brief Project 6
+ *
+ * @details A ping-pong (double) block buffer. The producer fills one block
+ *          while the consumer owns the other. Handing a finished block over
+ *          is a single word store, so no data is copied and it is safe
+ *          between an ISR or timer task and a consumer task.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef PINGPONG_H
+#define PINGPONG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief Value of pingpong_t.ready when the consumer holds no block.
+ */
+#define PINGPONG_NONE (0xFFFFFFFFu)
+
+/**
+ * @brief Ping-pong block buffer of 16 bit samples. Storage is provided by the caller.
+ */
+typedef struct pingpong_t {
+	uint16_t * blocks[2];
+	size_t blockSize;
+	size_t fill;              // samples in the filling block, producer owned
+	uint32_t fillIndex;       // block being filled, producer owned
+	volatile uint32_t ready;  // block handed to the consumer, or PINGPONG_NONE
+	uint32_t overruns;        // blocks dropped because the consumer was busy
+} pingpong_t;
+
+/**
+ * @brief Initialize a ping-pong buffer
+ * @param outBuf The buffer to initialize
+ * @param inStorage Storage for 2 * inBlockSize samples
+ * @param inBlockSize Samples per block
+ * @return buff_err_invalid if the arguments are bad
+ */
+buff_err pingpong_init(pingpong_t* outBuf, uint16_t* inStorage, size_t inBlockSize);
+
+/**
+ * @brief Add a sample to the filling block. Producer side only.
+ * @details When the block fills it is handed to the consumer and the producer
+ *          moves to the other block. If the consumer still holds the previous
+ *          block, the finished block is dropped, counted as an overrun and
+ *          refilled.
+ * @param inBuf Buffer to push to
+ * @param inSample Sample to push
+ * @return Whether this sample completed a block that was handed over
+ */
+bool pingpong_push(pingpong_t* inBuf, uint16_t inSample);
+
+/**
+ * @brief Get the block handed over by the producer. Consumer side only.
+ * @details The consumer owns the block until pingpong_release and may
+ *          modify it in place: the producer only writes the other block,
+ *          and drops a finished block rather than touch this one.
+ * @param inBuf Buffer to take from
+ * @param outCount Number of samples in the block
+ * @return The block, or NULL if none is ready
+ */
+uint16_t* pingpong_acquire(pingpong_t* inBuf, size_t* outCount);
+
+/**
+ * @brief Give the acquired block back to the producer. Consumer side only.
+ * @param inBuf Buffer to release
+ */
+void pingpong_release(pingpong_t* inBuf);
+
+#endif
@@ -0,0 +1,184 @@
+/*
+ * @file ring_notify.h
+ * @brief Project 6
+ *
+ * @details An SPSC ring that lets the consumer task sleep instead of poll.
+ *
+ *          The consumer arms a wake level and blocks on its task notification.
+ *          The producer, task or ISR, checks the level after each push and
+ *          gives the notification once when the ring reaches it. By default
+ *          the watermark is half the capacity, so a consumer waiting on it
+ *          wakes once per batch rather than once per element.
+ *
+ *          The wrapper uses the consumer task's notification value. A
+ *          notification given to that task for anything else ends its sleep
+ *          early; the wait then goes back to sleep for the time that is
+ *          left, so it still returns only at its level or its deadline, but
+ *          that other notification is consumed.
+ *
+ *          Rings are generated per element type like spsc_ring.h. A uint8_t
+ *          ring is provided as ring_notify_u8 and a uint32_t ring as ring_notify.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef RING_NOTIFY_H
+#define RING_NOTIFY_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "spsc_ring.h"
+
+/**
+ * @brief Declare a notifying ring name##_t over the SPSC ring type base##_t.
+ *
+ * name##_init(r, storage, capacity, watermark)  watermark 0 means capacity / 2
+ * name##_set_watermark(r, watermark)
+ * name##_push(r, data)                          producer task
+ * name##_push_from_isr(r, data, &woken)         producer ISR, yield on woken after
+ * name##_pop(r, &data, timeout)                 consumer, buff_err_empty on timeout
+ * name##_wait(r, level, timeout)                consumer, sleep until size >= level
+ * name##_wait_watermark(r, timeout)             consumer, sleep until the watermark
+ *
+ * Both waits return the ring size, which is below the level on timeout.
+ * Everything else, including bulk and in-place reads, goes through r->ring.
+ */
+#define RING_NOTIFY_DECLARE(name, base, type)                                             \
+typedef struct name##_t {                                                                 \
+	base##_t ring;                                                                        \
+	size_t watermark;                                                                     \
+	volatile size_t wakeLevel;      /* written by the consumer before arming */           \
+	TaskHandle_t volatile waiter;   /* armed consumer, cleared by whoever wakes it */     \
+} name##_t;                                                                               \
+                                                                                          \
+buff_err name##_init(name##_t* outRing, type * inStorage, size_t inCapacity,              \
+		             size_t inWatermark);                                                 \
+buff_err name##_set_watermark(name##_t* inRing, size_t inWatermark);                      \
+buff_err name##_push(name##_t* inRing, type inData);                                      \
+buff_err name##_push_from_isr(name##_t* inRing, type inData,                              \
+		                      BaseType_t* outHigherPriorityTaskWoken);                    \
+buff_err name##_pop(name##_t* inRing, type * outData, TickType_t inTimeout);              \
+size_t name##_wait(name##_t* inRing, size_t inLevel, TickType_t inTimeout);               \
+size_t name##_wait_watermark(name##_t* inRing, TickType_t inTimeout);
+
+/**
+ * @brief Define the functions declared by RING_NOTIFY_DECLARE. Use in one .c file.
+ */
+#define RING_NOTIFY_DEFINE(name, base, type)                                              \
+buff_err name##_init(name##_t* outRing, type * inStorage, size_t inCapacity,              \
+		             size_t inWatermark)                                                  \
+{                                                                                         \
+	buff_err err = base##_init(&outRing->ring, inStorage, inCapacity);                    \
+	if(err == buff_err_success)                                                           \
+	{                                                                                     \
+		outRing->waiter = NULL;                                                           \
+		outRing->wakeLevel = 1;                                                           \
+		outRing->watermark = inCapacity / 2;                                              \
+		err = name##_set_watermark(outRing, inWatermark ? inWatermark : inCapacity / 2);  \
+	}                                                                                     \
+	return err;                                                                           \
+}                                                                                         \
+                                                                                          \
+buff_err name##_set_watermark(name##_t* inRing, size_t inWatermark)                       \
+{                                                                                         \
+	if(!inWatermark || inWatermark > base##_capacity(&inRing->ring))                      \
+	{                                                                                     \
+		return buff_err_invalid;                                                          \
+	}                                                                                     \
+	inRing->watermark = inWatermark;                                                      \
+	return buff_err_success;                                                              \
+}                                                                                         \
+                                                                                          \
+/* Hands back the armed consumer, disarmed, if this push got the ring to its level */     \
+static inline TaskHandle_t name##_take_waiter(name##_t* inRing)                           \
+{                                                                                         \
+	TaskHandle_t waiter = inRing->waiter;                                                 \
+	if(waiter && base##_size(&inRing->ring) >= inRing->wakeLevel)                         \
+	{                                                                                     \
+		inRing->waiter = NULL;                                                            \
+		return waiter;                                                                    \
+	}                                                                                     \
+	return NULL;                                                                          \
+}                                                                                         \
+                                                                                          \
+buff_err name##_push(name##_t* inRing, type inData)                                       \
+{                                                                                         \
+	buff_err err = base##_push(&inRing->ring, inData);                                    \
+	TaskHandle_t waiter = name##_take_waiter(inRing);                                     \
+	if(waiter)                                                                            \
+	{                                                                                     \
+		xTaskNotifyGive(waiter);                                                          \
+	}                                                                                     \
+	return err;                                                                           \
+}                                                                                         \
+                                                                                          \
+buff_err name##_push_from_isr(name##_t* inRing, type inData,                              \
+		                      BaseType_t* outHigherPriorityTaskWoken)                     \
+{                                                                                         \
+	buff_err err = base##_push(&inRing->ring, inData);                                    \
+	TaskHandle_t waiter = name##_take_waiter(inRing);                                     \
+	if(waiter)                                                                            \
+	{                                                                                     \
+		vTaskNotifyGiveFromISR(waiter, outHigherPriorityTaskWoken);                       \
+	}                                                                                     \
+	return err;                                                                           \
+}                                                                                         \
+                                                                                          \
+size_t name##_wait(name##_t* inRing, size_t inLevel, TickType_t inTimeout)                \
+{                                                                                         \
+	size_t size = base##_size(&inRing->ring);                                             \
+	if(size < inLevel && inTimeout)                                                       \
+	{                                                                                     \
+		TimeOut_t start;                                                                  \
+		TickType_t remaining = inTimeout;                                                 \
+		vTaskSetTimeOutState(&start);                                                     \
+		/* drop a wake that arrived after an earlier wait had timed out */                \
+		(void)ulTaskNotifyTake(pdTRUE, 0);                                                \
+		inRing->wakeLevel = inLevel;                                                      \
+		do                                                                                \
+		{                                                                                 \
+			/* rearm, as a wake disarms, then recheck: a push in between */               \
+			/* would otherwise be missed */                                               \
+			inRing->waiter = xTaskGetCurrentTaskHandle();                                 \
+			size = base##_size(&inRing->ring);                                            \
+			if(size >= inLevel)                                                           \
+			{                                                                             \
+				break;                                                                    \
+			}                                                                             \
+			/* any notification ends the sleep, not only ours */                          \
+			(void)ulTaskNotifyTake(pdTRUE, remaining);                                    \
+			size = base##_size(&inRing->ring);                                            \
+		} while(size < inLevel && xTaskCheckForTimeOut(&start, &remaining) == pdFALSE);   \
+		inRing->waiter = NULL;                                                            \
+	}                                                                                     \
+	return size;                                                                          \
+}                                                                                         \
+                                                                                          \
+size_t name##_wait_watermark(name##_t* inRing, TickType_t inTimeout)                      \
+{                                                                                         \
+	return name##_wait(inRing, inRing->watermark, inTimeout);                             \
+}                                                                                         \
+                                                                                          \
+buff_err name##_pop(name##_t* inRing, type * outData, TickType_t inTimeout)               \
+{                                                                                         \
+	name##_wait(inRing, 1, inTimeout);                                                    \
+	return base##_pop(&inRing->ring, outData);                                            \
+}
+
+/**
+ * @brief Byte ring, e.g. for UART receive.
+ */
+RING_NOTIFY_DECLARE(ring_notify_u8, spsc_ring_u8, uint8_t)
+
+/**
+ * @brief Word ring.
+ */
+RING_NOTIFY_DECLARE(ring_notify, spsc_ring, uint32_t)
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * @file ring_stats.h
+ * @brief Project 6
+ *
+ * @details Optional occupancy and drop counters for the ring buffers, and a
+ *          registry so every registered buffer can be dumped through the logger.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef RING_STATS_H
+#define RING_STATS_H
+
+#include <stdint.h>
+
+/**
+ * @brief Whether the ring buffers keep counters
+ * @details Off in builds that define NDEBUG (Release). Define as 0 or 1 to override.
+ */
+#ifndef RING_STATS
+#ifdef NDEBUG
+#define RING_STATS (0)
+#else
+#define RING_STATS (1)
+#endif
+#endif
+
+/**
+ * @brief Counters for one buffer. Each counter has a single writer: the
+ *        producer owns pushes, overwrites, rejected and peak, the consumer
+ *        owns pops.
+ */
+typedef struct ring_stats_t {
+	const char* name;
+	uint32_t pushes;     // elements stored
+	uint32_t pops;       // elements consumed
+	uint32_t overwrites; // unread elements lost to a push
+	uint32_t rejected;   // pushes refused because the buffer was full
+	uint32_t peak;       // highest occupancy seen
+	struct ring_stats_t* next;
+} ring_stats_t;
+
+/**
+ * @brief Add a buffer's counters to the list dumped by ring_stats_log_all
+ * @param inStats Counters to add
+ * @param inName Name to print. Must outlive the registration.
+ */
+void ring_stats_register(ring_stats_t* inStats, const char* inName);
+
+/**
+ * @brief Remove a buffer's counters from the list. Harmless if not registered.
+ * @param inStats Counters to remove
+ */
+void ring_stats_unregister(ring_stats_t* inStats);
+
+/**
+ * @brief Move counters and registration to a new location, e.g. after a resize
+ * @param fromStats Old counters
+ * @param toStats New counters
+ */
+void ring_stats_move(ring_stats_t* fromStats, ring_stats_t* toStats);
+
+/**
+ * @brief Log the counters of every registered buffer
+ */
+void ring_stats_log_all();
+
+#if RING_STATS
+
+/**
+ * @brief Counter member to place in a buffer struct
+ */
+#define RING_STATS_FIELD ring_stats_t stats;
+
+/**
+ * @brief Add to one counter of a buffer
+ */
+#define RING_STATS_ADD(buf, counter, n) ((buf)->stats.counter += (n))
+
+/**
+ * @brief Record the buffer's occupancy for the high-water mark
+ */
+#define RING_STATS_PEAK(buf, occupancy)                       \
+	do                                                        \
+	{                                                         \
+		if((occupancy) > (buf)->stats.peak)                   \
+		{                                                     \
+			(buf)->stats.peak = (occupancy);                  \
+		}                                                     \
+	} while(0)
+
+/**
+ * @brief Zero a buffer's counters, keeping its registration
+ */
+#define RING_STATS_CLEAR(buf)                                 \
+	do                                                        \
+	{                                                         \
+		(buf)->stats.pushes = 0;                              \
+		(buf)->stats.pops = 0;                                \
+		(buf)->stats.overwrites = 0;                          \
+		(buf)->stats.rejected = 0;                            \
+		(buf)->stats.peak = 0;                                \
+	} while(0)
+
+/**
+ * @brief Register a buffer by name
+ */
+#define RING_STATS_REGISTER(buf, name) ring_stats_register(&(buf)->stats, name)
+
+#else
+
+#define RING_STATS_FIELD
+#define RING_STATS_ADD(buf, counter, n) ((void)0)
+#define RING_STATS_PEAK(buf, occupancy) ((void)0)
+#define RING_STATS_CLEAR(buf) ((void)0)
+#define RING_STATS_REGISTER(buf, name) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * @file running_median.h
+ * @brief Project 6
+ *
+ * @details Median of the last N samples, updated as each sample arrives,
+ *          to reject glitches that single samples put into min and max.
+ *
+ *          The window lives in one array of heap positions split around
+ *          the median: a max-heap of the samples below it on one side and a
+ *          min-heap of those above it on the other, with the median itself
+ *          at the centre. Each window slot remembers where its sample sits in
+ *          the heaps, so the oldest sample is overwritten in place by the new
+ *          one and sifted up or down: O(log N) per sample, with no sorting
+ *          and no allocation.
+ *
+ *          Storage is provided by the caller: RUNNING_MEDIAN_STORAGE(n)
+ *          half-words for a window of n samples.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef RUNNING_MEDIAN_H
+#define RUNNING_MEDIAN_H
+
+#include <stdint.h>
+#include "circular_buffer.h"
+
+/**
+ * @brief Half-words of storage for a window of inSize samples:
+ *        the samples, the heaps, and each sample's place in the heaps.
+ */
+#define RUNNING_MEDIAN_STORAGE(inSize) (3 * (inSize))
+
+/**
+ * @brief Running median over unsigned 16 bit samples
+ */
+typedef struct running_median_t {
+	uint16_t* samples;
+	uint16_t* heap;      // window slots, indexed -maxCount to minCount; 0 is the median
+	int16_t* positions;  // each slot's index in heap
+	uint32_t size;       // window length
+	uint32_t count;      // samples in the window, up to size
+	uint32_t next;       // slot the next sample is written to
+} running_median_t;
+
+/**
+ * @brief Initialize an empty window
+ * @param outMedian Window to initialize
+ * @param inStorage RUNNING_MEDIAN_STORAGE(inSize) half-words
+ * @param inSize Window length, 1 to 65535 samples. Odd lengths have a
+ *        true middle sample; for even ones the upper of the middle two is used.
+ * @return buff_err_invalid if the arguments are bad
+ */
+buff_err running_median_init(running_median_t* outMedian, uint16_t* inStorage, uint32_t inSize);
+
+/**
+ * @brief Add a sample, dropping the oldest once the window is full
+ * @param inMedian Window to update
+ * @param inSample Sample to add
+ * @return The median of the window, including inSample
+ */
+uint16_t running_median_push(running_median_t* inMedian, uint16_t inSample);
+
+/**
+ * @brief Median of the window. Only valid if the window is not empty.
+ */
+static inline uint16_t running_median_value(const running_median_t* inMedian)
+{
+	return inMedian->samples[inMedian->heap[0]];
+}
+
+#endif
@@ -17,6 +17,17 @@
 
 #include <stdint.h>
 
+/**
+ * Samples in one period of the sine, one per DAC write.
+ */
+#define NUM_SINE_SAMPLES 50
+
+/**
+ * Amplitude and DC offset of the sine, in millivolts: it swings from 1 V to 3 V.
+ */
+#define SINE_AMPLITUDE_MV 1000
+#define SINE_OFFSET_MV 2000
+
 /**
  * Initialize the sine wave lookup table.
  */
@@ -0,0 +1,102 @@
+/*
+ * @file sliding_stats.h
+ * @brief Project 6
+ *
+ * @details Statistics over the last N samples, updated as each sample arrives.
+ *
+ *          The window keeps a running sum and sum of squares, adding the new
+ *          sample and subtracting the one that falls out, so mean and
+ *          variance are O(1) per sample. Min and max come from two monotonic
+ *          deques of window positions: each sample is pushed and popped at
+ *          most once, so they are amortized O(1) per sample too.
+ *
+ *          Storage is provided by the caller: SLIDING_STATS_STORAGE(n)
+ *          half-words for a window of n samples.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef SLIDING_STATS_H
+#define SLIDING_STATS_H
+
+#include <stdint.h>
+#include "circular_buffer.h"
+#include "stream_stats.h"
+
+/**
+ * @brief Half-words of storage for a window of inSize samples:
+ *        the samples, and a min and a max deque of positions.
+ */
+#define SLIDING_STATS_STORAGE(inSize) (3 * (inSize))
+
+/**
+ * @brief A ring of window positions, oldest at head
+ */
+typedef struct sliding_deque_t {
+	uint16_t* positions;
+	uint32_t head;
+	uint32_t length;
+} sliding_deque_t;
+
+/**
+ * @brief Sliding window over unsigned 16 bit samples
+ */
+typedef struct sliding_stats_t {
+	uint16_t* samples;
+	uint32_t size;       // window length
+	uint32_t count;      // samples in the window, up to size
+	uint32_t next;       // position the next sample is written to
+	uint32_t sum;
+	uint64_t sumSquares;
+	sliding_deque_t minDeque; // increasing values, front is the min
+	sliding_deque_t maxDeque; // decreasing values, front is the max
+} sliding_stats_t;
+
+/**
+ * @brief Initialize an empty window
+ * @param outStats Window to initialize
+ * @param inStorage SLIDING_STATS_STORAGE(inSize) half-words
+ * @param inSize Window length, 1 to 65536 samples
+ * @return buff_err_invalid if the arguments are bad
+ */
+buff_err sliding_stats_init(sliding_stats_t* outStats, uint16_t* inStorage, uint32_t inSize);
+
+/**
+ * @brief Add a sample, dropping the oldest once the window is full
+ * @param inStats Window to update
+ * @param inSample Sample to add
+ */
+void sliding_stats_push(sliding_stats_t* inStats, uint16_t inSample);
+
+/**
+ * @brief Smallest sample in the window. Only valid if the window is not empty.
+ */
+static inline uint16_t sliding_stats_min(const sliding_stats_t* inStats)
+{
+	return inStats->samples[inStats->minDeque.positions[inStats->minDeque.head]];
+}
+
+/**
+ * @brief Largest sample in the window. Only valid if the window is not empty.
+ */
+static inline uint16_t sliding_stats_max(const sliding_stats_t* inStats)
+{
+	return inStats->samples[inStats->maxDeque.positions[inStats->maxDeque.head]];
+}
+
+/**
+ * @brief Copy the window's statistics out, e.g. for adc_stats_report
+ * @details The copy is not atomic. If samples are pushed from another
+ *          context, take it with that context held off.
+ * @param inStats Window to read
+ * @param outStats count, min, max, sum and sum of squares of the window
+ */
+void sliding_stats_snapshot(const sliding_stats_t* inStats, stream_stats_t* outStats);
+
+#endif
@@ -0,0 +1,292 @@
+/*
+ * @file spsc_ring.h
+ * @brief Project 6
+ *
+ * @details A lock-free single-producer/single-consumer ring buffer for
+ *          handing data between an ISR and a task.
+ *
+ *          The producer only ever writes head and the consumer only ever
+ *          writes tail. Both are free-running 32 bit counters, so each side
+ *          publishes its progress with one aligned word store. That is atomic
+ *          on the Cortex-M0+ without LDREX/STREX or masking interrupts.
+ *
+ *          The ring is generated per element type from one implementation by
+ *          SPSC_RING_DECLARE/SPSC_RING_DEFINE. uint8_t, uint16_t and uint32_t
+ *          rings are provided as spsc_ring_u8, spsc_ring_u16 and spsc_ring
+ *          (uint32_t). Other types, including structs, can be instantiated
+ *          the same way in the module that needs them.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "circular_buffer.h"
+#include "ring_stats.h"
+
+/**
+ * Read the other side's index. Acquire orders the slot access after it.
+ * On the M0+ this is a plain LDR followed by a DMB.
+ */
+#define SPSC_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+
+/**
+ * Publish our own index. Release orders the slot access before it.
+ * On the M0+ this is a DMB followed by a plain STR.
+ */
+#define SPSC_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/**
+ * @brief Declare a ring type name##_t holding elements of type, and its functions.
+ *
+ * name##_init(ring, storage, capacity)  capacity must be a power of two
+ * name##_reset(ring)                    empty the ring, neither side may be active
+ * name##_stats_reset(ring)              zero the counters, keeping the registration
+ * name##_copy(from, to)                 copy the indices, e.g. after a DMA copy of storage
+ * name##_push(ring, data)               producer, buff_err_full if no room
+ * name##_pop(ring, &data)               consumer, buff_err_empty if nothing to pop
+ * name##_push_n / name##_pop_n          bulk versions, at most two memcpy calls
+ * name##_peek_write / name##_commit_write  producer, fill the free region in place
+ * name##_peek_read / name##_commit_read    consumer, read the used region in place
+ * name##_empty / full / size / capacity
+ *
+ * With RING_STATS on, the ring also counts pushes, pops, rejected pushes and
+ * its high-water mark. Register it with RING_STATS_REGISTER to have them logged.
+ */
+#define SPSC_RING_DECLARE(name, type)                                                     \
+typedef struct name##_t {                                                                 \
+	type * buffer;                                                                        \
+	uint32_t mask;                                                                        \
+	volatile uint32_t head; /* next slot to write, producer owned */                      \
+	volatile uint32_t tail; /* next slot to read, consumer owned */                       \
+	RING_STATS_FIELD                                                                      \
+} name##_t;                                                                               \
+                                                                                          \
+typedef struct name##_span_t {                                                            \
+	type * data;                                                                          \
+	size_t count;                                                                         \
+} name##_span_t;                                                                          \
+                                                                                          \
+buff_err name##_init(name##_t* outRing, type * inStorage, size_t inCapacity);             \
+void name##_reset(name##_t* inRing);                                                      \
+void name##_stats_reset(name##_t* inRing);                                                \
+void name##_copy(name##_t* fromRing, name##_t* toRing);                                   \
+buff_err name##_push(name##_t* inRing, type inData);                                      \
+buff_err name##_pop(name##_t* inRing, type * outData);                                    \
+buff_err name##_push_n(name##_t* inRing, const type * inData, size_t inCount,             \
+		               size_t* outCount);                                                 \
+buff_err name##_pop_n(name##_t* inRing, type * outData, size_t inCount,                   \
+		              size_t* outCount);                                                  \
+size_t name##_peek_write(name##_t* inRing, name##_span_t outSpans[2]);                    \
+buff_err name##_commit_write(name##_t* inRing, size_t inCount);                           \
+size_t name##_peek_read(name##_t* inRing, name##_span_t outSpans[2]);                     \
+buff_err name##_commit_read(name##_t* inRing, size_t inCount);                            \
+bool name##_empty(name##_t* inRing);                                                      \
+bool name##_full(name##_t* inRing);                                                       \
+size_t name##_size(name##_t* inRing);                                                     \
+size_t name##_capacity(name##_t* inRing);
+
+/**
+ * @brief Define the functions declared by SPSC_RING_DECLARE. Use in one .c file.
+ */
+#define SPSC_RING_DEFINE(name, type)                                                      \
+buff_err name##_init(name##_t* outRing, type * inStorage, size_t inCapacity)              \
+{                                                                                         \
+	/* capacity must be a non-zero power of two that fits the free-running counters */    \
+	if(!outRing || !inStorage || !inCapacity ||                                           \
+	   (inCapacity & (inCapacity - 1)) || inCapacity > 0x80000000u)                       \
+	{                                                                                     \
+		return buff_err_invalid;                                                          \
+	}                                                                                     \
+	outRing->buffer = inStorage;                                                          \
+	outRing->mask = (uint32_t)(inCapacity - 1);                                           \
+	outRing->head = 0;                                                                    \
+	outRing->tail = 0;                                                                    \
+	name##_stats_reset(outRing);                                                          \
+	return buff_err_success;                                                              \
+}                                                                                         \
+                                                                                          \
+void name##_reset(name##_t* inRing)                                                       \
+{                                                                                         \
+	inRing->head = 0;                                                                     \
+	inRing->tail = 0;                                                                     \
+}                                                                                         \
+                                                                                          \
+void name##_stats_reset(name##_t* inRing)                                                 \
+{                                                                                         \
+	RING_STATS_CLEAR(inRing);                                                             \
+}                                                                                         \
+                                                                                          \
+void name##_copy(name##_t* fromRing, name##_t* toRing)                                    \
+{                                                                                         \
+	toRing->tail = fromRing->tail;                                                        \
+	toRing->head = fromRing->head;                                                        \
+}                                                                                         \
+                                                                                          \
+buff_err name##_push(name##_t* inRing, type inData)                                       \
+{                                                                                         \
+	uint32_t head = inRing->head;                                                         \
+	uint32_t tail = SPSC_LOAD_ACQUIRE(&inRing->tail);                                     \
+	if((head - tail) > inRing->mask)                                                      \
+	{                                                                                     \
+		RING_STATS_ADD(inRing, rejected, 1);                                              \
+		return buff_err_full;                                                             \
+	}                                                                                     \
+	inRing->buffer[head & inRing->mask] = inData;                                         \
+	SPSC_STORE_RELEASE(&inRing->head, head + 1);                                          \
+	RING_STATS_ADD(inRing, pushes, 1);                                                    \
+	RING_STATS_PEAK(inRing, head + 1 - tail);                                             \
+	return buff_err_success;                                                              \
+}                                                                                         \
+                                                                                          \
+buff_err name##_pop(name##_t* inRing, type * outData)                                     \
+{                                                                                         \
+	uint32_t tail = inRing->tail;                                                         \
+	uint32_t head = SPSC_LOAD_ACQUIRE(&inRing->head);                                     \
+	if(head == tail)                                                                      \
+	{                                                                                     \
+		return buff_err_empty;                                                            \
+	}                                                                                     \
+	*outData = inRing->buffer[tail & inRing->mask];                                       \
+	SPSC_STORE_RELEASE(&inRing->tail, tail + 1);                                          \
+	RING_STATS_ADD(inRing, pops, 1);                                                      \
+	return buff_err_success;                                                              \
+}                                                                                         \
+                                                                                          \
+size_t name##_peek_write(name##_t* inRing, name##_span_t outSpans[2])                     \
+{                                                                                         \
+	uint32_t head = inRing->head;                                                         \
+	uint32_t space = inRing->mask + 1 - (head - SPSC_LOAD_ACQUIRE(&inRing->tail));        \
+	uint32_t index = head & inRing->mask;                                                 \
+	uint32_t toEnd = inRing->mask + 1 - index;                                            \
+	outSpans[0].data = &inRing->buffer[index];                                            \
+	outSpans[0].count = (space < toEnd) ? space : toEnd;                                  \
+	outSpans[1].data = inRing->buffer;                                                    \
+	outSpans[1].count = space - outSpans[0].count;                                        \
+	return space;                                                                         \
+}                                                                                         \
+                                                                                          \
+buff_err name##_commit_write(name##_t* inRing, size_t inCount)                            \
+{                                                                                         \
+	uint32_t head = inRing->head;                                                         \
+	uint32_t tail = SPSC_LOAD_ACQUIRE(&inRing->tail);                                     \
+	if(inCount > inRing->mask + 1 - (head - tail))                                        \
+	{                                                                                     \
+		return buff_err_invalid;                                                          \
+	}                                                                                     \
+	SPSC_STORE_RELEASE(&inRing->head, head + (uint32_t)inCount);                          \
+	RING_STATS_ADD(inRing, pushes, inCount);                                              \
+	RING_STATS_PEAK(inRing, head + (uint32_t)inCount - tail);                             \
+	return buff_err_success;                                                              \
+}                                                                                         \
+                                                                                          \
+size_t name##_peek_read(name##_t* inRing, name##_span_t outSpans[2])                      \
+{                                                                                         \
+	uint32_t tail = inRing->tail;                                                         \
+	uint32_t used = SPSC_LOAD_ACQUIRE(&inRing->head) - tail;                              \
+	uint32_t index = tail & inRing->mask;                                                 \
+	uint32_t toEnd = inRing->mask + 1 - index;                                            \
+	outSpans[0].data = &inRing->buffer[index];                                            \
+	outSpans[0].count = (used < toEnd) ? used : toEnd;                                    \
+	outSpans[1].data = inRing->buffer;                                                    \
+	outSpans[1].count = used - outSpans[0].count;                                         \
+	return used;                                                                          \
+}                                                                                         \
+                                                                                          \
+buff_err name##_commit_read(name##_t* inRing, size_t inCount)                             \
+{                                                                                         \
+	uint32_t tail = inRing->tail;                                                         \
+	if(inCount > SPSC_LOAD_ACQUIRE(&inRing->head) - tail)                                 \
+	{                                                                                     \
+		return buff_err_invalid;                                                          \
+	}                                                                                     \
+	SPSC_STORE_RELEASE(&inRing->tail, tail + (uint32_t)inCount);                          \
+	RING_STATS_ADD(inRing, pops, inCount);                                                \
+	return buff_err_success;                                                              \
+}                                                                                         \
+                                                                                          \
+buff_err name##_push_n(name##_t* inRing, const type * inData, size_t inCount,             \
+		               size_t* outCount)                                                  \
+{                                                                                         \
+	name##_span_t spans[2];                                                               \
+	size_t space = name##_peek_write(inRing, spans);                                      \
+	size_t count = (inCount < space) ? inCount : space;                                   \
+	size_t first = (count < spans[0].count) ? count : spans[0].count;                     \
+	memcpy(spans[0].data, inData, first * sizeof(type));                                  \
+	memcpy(spans[1].data, inData + first, (count - first) * sizeof(type));                \
+	name##_commit_write(inRing, count);                                                   \
+	RING_STATS_ADD(inRing, rejected, inCount - count);                                    \
+	if(outCount)                                                                          \
+	{                                                                                     \
+		*outCount = count;                                                                \
+	}                                                                                     \
+	return (count == inCount) ? buff_err_success : buff_err_full;                         \
+}                                                                                         \
+                                                                                          \
+buff_err name##_pop_n(name##_t* inRing, type * outData, size_t inCount,                   \
+		              size_t* outCount)                                                   \
+{                                                                                         \
+	name##_span_t spans[2];                                                               \
+	size_t used = name##_peek_read(inRing, spans);                                        \
+	size_t count = (inCount < used) ? inCount : used;                                     \
+	size_t first = (count < spans[0].count) ? count : spans[0].count;                     \
+	memcpy(outData, spans[0].data, first * sizeof(type));                                 \
+	memcpy(outData + first, spans[1].data, (count - first) * sizeof(type));               \
+	name##_commit_read(inRing, count);                                                    \
+	if(outCount)                                                                          \
+	{                                                                                     \
+		*outCount = count;                                                                \
+	}                                                                                     \
+	return (used == 0) ? buff_err_empty : buff_err_success;                               \
+}                                                                                         \
+                                                                                          \
+bool name##_empty(name##_t* inRing)                                                       \
+{                                                                                         \
+	return name##_size(inRing) == 0;                                                      \
+}                                                                                         \
+                                                                                          \
+bool name##_full(name##_t* inRing)                                                        \
+{                                                                                         \
+	return name##_size(inRing) > inRing->mask;                                            \
+}                                                                                         \
+                                                                                          \
+size_t name##_size(name##_t* inRing)                                                      \
+{                                                                                         \
+	/* unsigned subtraction handles counter wrap */                                       \
+	uint32_t tail = SPSC_LOAD_ACQUIRE(&inRing->tail);                                     \
+	uint32_t head = SPSC_LOAD_ACQUIRE(&inRing->head);                                     \
+	return (size_t)(head - tail);                                                         \
+}                                                                                         \
+                                                                                          \
+size_t name##_capacity(name##_t* inRing)                                                  \
+{                                                                                         \
+	return (size_t)inRing->mask + 1;                                                      \
+}
+
+/**
+ * @brief Byte ring, e.g. for UART characters.
+ */
+SPSC_RING_DECLARE(spsc_ring_u8, uint8_t)
+
+/**
+ * @brief Half-word ring, e.g. for 12 bit ADC samples.
+ */
+SPSC_RING_DECLARE(spsc_ring_u16, uint16_t)
+
+/**
+ * @brief Word ring.
+ */
+SPSC_RING_DECLARE(spsc_ring, uint32_t)
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * @file stream_stats.h
+ * @brief Project 6
+ *
+ * @details Single-pass statistics over a stream of integer samples.
+ *
+ *          Each sample updates a count, min, max, sum and sum of squares in
+ *          O(1) with integer adds and one 32 bit multiply, so nothing is
+ *          rounded as samples arrive. Mean and variance are only derived when
+ *          a report asks for them, and are exact for any run up to 2^32
+ *          samples, which is months of continuous sampling at the ADC rate.
+ *
+ *          Keep one stream_stats_t per window. A per-block window is reset
+ *          every block and merged into a lifetime window in O(1).
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef STREAM_STATS_H
+#define STREAM_STATS_H
+
+#include <stdint.h>
+
+/**
+ * @brief Largest sample magnitude stream_stats_add accepts
+ * @details Keeps each square in 32 bits. Raw 12 bit ADC codes and Q15 values fit.
+ */
+#define STREAM_STATS_MAX_MAGNITUDE (65535)
+
+/**
+ * @brief Running statistics for one window of samples
+ */
+typedef struct stream_stats_t {
+	uint32_t count;
+	int32_t min;
+	int32_t max;
+	int64_t sum;
+	uint64_t sumSquares;
+} stream_stats_t;
+
+/**
+ * @brief Empty a window
+ * @param outStats Window to reset
+ */
+void stream_stats_reset(stream_stats_t* outStats);
+
+/**
+ * @brief Add one sample to a window
+ * @param inStats Window to update
+ * @param inSample Sample, within +/- STREAM_STATS_MAX_MAGNITUDE
+ */
+static inline void stream_stats_add(stream_stats_t* inStats, int32_t inSample)
+{
+	uint32_t magnitude = inSample < 0 ? (uint32_t)-inSample : (uint32_t)inSample;
+	if(inSample < inStats->min)
+	{
+		inStats->min = inSample;
+	}
+	if(inSample > inStats->max)
+	{
+		inStats->max = inSample;
+	}
+	inStats->count++;
+	inStats->sum += inSample;
+	inStats->sumSquares += magnitude * magnitude;
+}
+
+/**
+ * @brief Add a block of unsigned 16 bit samples, e.g. raw ADC codes
+ * @param inStats Window to update
+ * @param inSamples Samples to add
+ * @param inCount Number of samples, at most 65536
+ */
+void stream_stats_add_block_u16(stream_stats_t* inStats, const uint16_t* inSamples, uint32_t inCount);
+
+/**
+ * @brief Fold one window into another, e.g. a finished block into the lifetime totals
+ * @param inOutTotal Window to add to
+ * @param inStats Window to add
+ */
+void stream_stats_merge(stream_stats_t* inOutTotal, const stream_stats_t* inStats);
+
+/**
+ * @brief Sum of squared differences from the mean, rounded down
+ * @details Variance is this over count, or over count - 1 for the sample variance.
+ * @param inStats Window to read
+ * @return 0 for an empty window
+ */
+uint64_t stream_stats_sum_squared_deviations(const stream_stats_t* inStats);
+
+/**
+ * @brief Population variance with a binary fraction, rounded down
+ * @param inStats Window to read
+ * @param inFractionBits Fraction bits of the result, at most 30
+ * @return Variance in units of 2^-inFractionBits. 0 for an empty window.
+ */
+uint64_t stream_stats_variance_q(const stream_stats_t* inStats, uint32_t inFractionBits);
+
+/**
+ * @brief Population standard deviation with a binary fraction, rounded down
+ * @details Integer only, see isqrt.h.
+ * @param inStats Window to read
+ * @param inFractionBits Fraction bits of the result, at most 15
+ * @return Standard deviation in units of 2^-inFractionBits. 0 for an empty window.
+ */
+uint32_t stream_stats_stddev_q(const stream_stats_t* inStats, uint32_t inFractionBits);
+
+/**
+ * @brief Mean of the window. For reports, not per sample.
+ * @param inStats Window to read
+ * @return 0 for an empty window
+ */
+float stream_stats_mean(const stream_stats_t* inStats);
+
+/**
+ * @brief Population variance of the window. For reports, not per sample.
+ * @param inStats Window to read
+ * @return 0 for an empty window
+ */
+float stream_stats_variance(const stream_stats_t* inStats);
+
+#endif
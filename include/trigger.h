@@ -0,0 +1,103 @@
+/*
+ * @file trigger.h
+ * @brief Project 6
+ *
+ * @details Oscilloscope-style trigger on the sample stream. Samples wait in a
+ *          short pre-trigger history until the trigger condition holds, then
+ *          the history and the samples after the trigger are pushed into a
+ *          ping-pong buffer as one frozen block. Everything else is dropped,
+ *          so the DSP task only runs on captures.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "circular_buffer.h"
+#include "pingpong.h"
+
+/**
+ * @brief What makes a sample the trigger point
+ */
+typedef enum trigger_mode {
+	trigger_mode_free_run, // every sample, blocks are back to back
+	trigger_mode_level,    // any sample at or above level
+	trigger_mode_rising,   // crossing up through level, after dropping below level - hysteresis
+	trigger_mode_falling,  // crossing down through level, after rising above level + hysteresis
+	trigger_mode_window    // any sample outside [low, high]
+} trigger_mode;
+
+/**
+ * @brief Trigger settings. Levels are in ADC codes, lengths in samples.
+ */
+typedef struct trigger_config_t {
+	trigger_mode mode;
+	uint16_t level;
+	uint16_t hysteresis;
+	uint16_t low;
+	uint16_t high;
+	uint32_t preTrigger;  // samples before the trigger point in each capture
+	uint32_t holdoff;     // samples ignored after a capture before rearming
+	uint32_t autoTimeout; // armed samples before forcing a capture, 0 waits forever
+} trigger_config_t;
+
+/**
+ * @brief Trigger state. The history storage is provided by the caller.
+ */
+typedef struct trigger_t {
+	trigger_config_t config;
+	uint16_t* history;   // preTrigger most recent samples, circular
+	uint32_t historyFill;
+	uint32_t historyNext;
+	uint32_t postLeft;   // samples still to capture, 0 when not capturing
+	uint32_t holdoffLeft;
+	uint32_t waiting;    // armed samples without a trigger
+	bool edgeArmed;      // the signal has been on the far side of the hysteresis band
+	uint32_t triggers;   // captures started by the condition
+	uint32_t forced;     // captures started by the auto timeout
+} trigger_t;
+
+/**
+ * @brief Initialize a trigger feeding blocks of inBlockSize samples
+ * @param outTrigger Trigger to initialize
+ * @param inConfig Settings, copied
+ * @param inHistory Storage for inConfig->preTrigger samples, NULL if that is 0
+ * @param inBlockSize Samples per capture, the ping-pong block size
+ * @return buff_err_invalid if the pre-trigger history does not leave room for
+ *         the trigger sample, or the window is empty
+ */
+buff_err trigger_init(trigger_t* outTrigger, const trigger_config_t* inConfig,
+		              uint16_t* inHistory, uint32_t inBlockSize);
+
+/**
+ * @brief Feed one sample. Producer side only.
+ * @details The trigger arms once the history holds preTrigger samples and any
+ *          holdoff has passed. When it fires, the history, oldest first, and
+ *          the trigger sample go into inOut, and the next samples follow until
+ *          the block is complete. The trigger sample is at index preTrigger.
+ * @param inTrigger Trigger to feed
+ * @param inOut Ping-pong buffer the captures are pushed to. Its filling block
+ *              must be empty, which holds if only this trigger feeds it.
+ * @param inSample Sample to feed
+ * @return Whether this sample completed a capture that was handed over
+ */
+bool trigger_push(trigger_t* inTrigger, pingpong_t* inOut, uint16_t inSample);
+
+/**
+ * @brief Whether a capture is in progress
+ */
+static inline bool trigger_capturing(const trigger_t* inTrigger)
+{
+	return inTrigger->postLeft != 0;
+}
+
+#endif
@@ -24,7 +24,9 @@
 /**
  * @brief Whether to use polling or interrupts for UART communication
  */
+#ifndef USE_UART_INTERRUPTS
 #define USE_UART_INTERRUPTS 	(0) // 0 for polled UART communications, 1 for interrupt-driven
+#endif
 
 /**
  * @brief How much to oversample the uart clock
@@ -49,6 +51,16 @@ void uart_init(int64_t baud_rate);
  */
 bool uart_getchar(uint8_t* outChar);
 
+/**
+ * @brief Sleep until a character is received or the timeout expires
+ * @details With USE_UART_INTERRUPTS the receive interrupt wakes the caller;
+ *          polled, the receiver is checked once per tick.
+ * @param outChar The character received
+ * @param inTimeoutTicks How many RTOS ticks to wait, portMAX_DELAY for ever
+ * @return Whether a character was received.
+ */
+bool uart_getchar_wait(uint8_t* outChar, uint32_t inTimeoutTicks);
+
 /**
  * @brief Transmit a character over UART
  * @param ch Character to transmit
@@ -78,4 +90,12 @@ void uart_put_string(const char* inChar);
  */
 bool uart_echo(uint8_t* outChar);
 
+/**
+ * @brief Sleep until a character is received, then transmit it back.
+ * @param outChar Output parameter for the character received
+ * @param inTimeoutTicks How many RTOS ticks to wait, portMAX_DELAY for ever
+ * @return Whether we echo'd.
+ */
+bool uart_echo_wait(uint8_t* outChar, uint32_t inTimeoutTicks);
+
 #endif
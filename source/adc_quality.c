@@ -0,0 +1,197 @@
+/*
+ * @file adc_quality.c
+ * @brief Project 6
+ *
+ * @details Closed-loop converter quality from a sine fit on the DAC stimulus.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "adc_quality.h"
+#include "adc_stats.h"
+#include "const_trig.h"
+#include "isqrt.h"
+#include "sine.h"
+
+/**
+ * Entries in the period tables; only the first NUM_SINE_SAMPLES are used.
+ */
+#define QUALITY_TABLE_LENGTH 64
+
+#if NUM_SINE_SAMPLES > QUALITY_TABLE_LENGTH
+#error "NUM_SINE_SAMPLES does not fit the quality tables"
+#endif
+
+#if 2 * ADC_QUALITY_HARMONICS >= NUM_SINE_SAMPLES
+#error "ADC_QUALITY_HARMONICS must stay below half of NUM_SINE_SAMPLES"
+#endif
+
+/**
+ * One period of the stimulus, cos and sin in 2.14, where 1.0 is exact, so
+ * fitted amplitudes carry no 32767 / 32768 gain error. Harmonic h at
+ * sample n is entry (h n) mod NUM_SINE_SAMPLES, so no other tables are needed.
+ */
+#define QUALITY_ANGLE(k) CONST_TRIG_ANGLE((k) % NUM_SINE_SAMPLES, NUM_SINE_SAMPLES)
+#define QUALITY_Q14(v) ((int16_t)((v) * 16384.0 + (((v) < 0.0) ? -0.5 : 0.5)))
+#define QUALITY_COS(k) QUALITY_Q14(CONST_TRIG_COS(QUALITY_ANGLE(k))),
+#define QUALITY_SIN(k) QUALITY_Q14(CONST_TRIG_SIN(QUALITY_ANGLE(k))),
+
+static const int16_t sPeriodCos[QUALITY_TABLE_LENGTH] = { CONST_TRIG_REPEAT_64(QUALITY_COS, 0) };
+static const int16_t sPeriodSin[QUALITY_TABLE_LENGTH] = { CONST_TRIG_REPEAT_64(QUALITY_SIN, 0) };
+
+/**
+ * Nominal stimulus in ADC codes with 15 fractional bits.
+ */
+#define QUALITY_CODES_Q15(inMv) \
+	((((int64_t)(inMv)) << (ADC_RESOLUTION_BITS + 15)) / ADC_VREF_MV)
+
+/**
+ * Fractional bits of the residual, so energies are in codes^2 with 16.
+ */
+#define QUALITY_ENERGY_BITS 8
+
+/**
+ * log2(inValue) for inValue >= 1, with 16 fractional bits.
+ *
+ * The integer part is the top set bit. The fraction comes a bit at a time
+ * from squaring the mantissa: each squaring doubles the log, and a result
+ * of 2 or more means that bit is set.
+ */
+static int32_t log2_q16(uint64_t inValue)
+{
+	int32_t top = 63;
+	while(!(inValue >> top))
+	{
+		top--;
+	}
+
+	// mantissa in [1, 2) with 30 fractional bits
+	uint64_t mantissa = top >= 30 ? inValue >> (top - 30) : inValue << (30 - top);
+	int32_t fraction = 0;
+	for(int32_t bit = 15; bit >= 0; bit--)
+	{
+		mantissa = (mantissa * mantissa) >> 30;
+		if(mantissa >= (2ull << 30))
+		{
+			mantissa >>= 1;
+			fraction |= 1 << bit;
+		}
+	}
+	return (top << 16) | fraction;
+}
+
+int32_t adc_quality_ratio_centidb(uint64_t inNumerator, uint64_t inDenominator)
+{
+	int64_t log2Ratio = (int64_t)log2_q16(inNumerator ? inNumerator : 1u)
+			          - log2_q16(inDenominator ? inDenominator : 1u);
+
+	// 1000 log10(x) = 301.03 log2(x), rounded to nearest
+	int64_t scaled = log2Ratio * 30103;
+	int64_t half = scaled < 0 ? -(50 << 16) : (50 << 16);
+	return (int32_t)((scaled + half) / (100 << 16));
+}
+
+buff_err adc_quality_measure(const uint16_t* inBlock, uint32_t inCount, adc_quality_t* outQuality)
+{
+	if(!inBlock || !outQuality || inCount < NUM_SINE_SAMPLES)
+	{
+		return buff_err_invalid;
+	}
+
+	uint32_t length = NUM_SINE_SAMPLES;
+	while(length + NUM_SINE_SAMPLES <= inCount)
+	{
+		length += NUM_SINE_SAMPLES;
+	}
+
+	uint32_t sum = 0;
+	for(uint32_t n = 0; n < length; n++)
+	{
+		sum += inBlock[n];
+	}
+	int32_t centre = (int32_t)((sum + length / 2) / length);
+	int32_t meanQ15 = (int32_t)(((int64_t)sum << 15) / length);
+
+	/**
+	 * Over whole periods, the least-squares coefficients of cos(h w n) and
+	 * sin(h w n) are 2 / length times their correlations with the block.
+	 * Centering first keeps the products small; it does not change them.
+	 */
+	int64_t cosSums[ADC_QUALITY_HARMONICS] = {0};
+	int64_t sinSums[ADC_QUALITY_HARMONICS] = {0};
+	uint32_t phases[ADC_QUALITY_HARMONICS] = {0};
+	for(uint32_t n = 0; n < length; n++)
+	{
+		int32_t x = (int32_t)inBlock[n] - centre;
+		for(uint32_t h = 0; h < ADC_QUALITY_HARMONICS; h++)
+		{
+			cosSums[h] += x * sPeriodCos[phases[h]];
+			sinSums[h] += x * sPeriodSin[phases[h]];
+			phases[h] += h + 1;
+			phases[h] -= phases[h] >= NUM_SINE_SAMPLES ? NUM_SINE_SAMPLES : 0;
+		}
+	}
+
+	// coefficients in codes with 15 fractional bits: 2 / length, and 2 for the 2.14 tables
+	int32_t cosCoeffs[ADC_QUALITY_HARMONICS];
+	int32_t sinCoeffs[ADC_QUALITY_HARMONICS];
+	// the fundamental is the signal, the rest are distortion
+	uint64_t signal = 0;
+	uint64_t distortion = 0;
+	for(uint32_t h = 0; h < ADC_QUALITY_HARMONICS; h++)
+	{
+		cosCoeffs[h] = (int32_t)((4 * cosSums[h]) / (int32_t)length);
+		sinCoeffs[h] = (int32_t)((4 * sinSums[h]) / (int32_t)length);
+		phases[h] = 0;
+
+		// a tone of amplitude A carries length A^2 / 2 over the block
+		uint64_t squared = (uint64_t)((int64_t)cosCoeffs[h] * cosCoeffs[h])
+				         + (uint64_t)((int64_t)sinCoeffs[h] * sinCoeffs[h]);
+		uint64_t energy = (squared >> (30 - 2 * QUALITY_ENERGY_BITS)) * length / 2;
+		if(h)
+		{
+			distortion += energy;
+		}
+		else
+		{
+			signal = energy;
+		}
+	}
+
+	// what the fit leaves is the noise
+	uint64_t noise = 0;
+	for(uint32_t n = 0; n < length; n++)
+	{
+		int64_t fit = (int64_t)meanQ15 << 14;
+		for(uint32_t h = 0; h < ADC_QUALITY_HARMONICS; h++)
+		{
+			fit += (int64_t)cosCoeffs[h] * sPeriodCos[phases[h]]
+				 + (int64_t)sinCoeffs[h] * sPeriodSin[phases[h]];
+			phases[h] += h + 1;
+			phases[h] -= phases[h] >= NUM_SINE_SAMPLES ? NUM_SINE_SAMPLES : 0;
+		}
+		int64_t residual = (((int64_t)inBlock[n] << 29) - fit) >> (29 - QUALITY_ENERGY_BITS);
+		noise += (uint64_t)(residual * residual);
+	}
+
+	outQuality->samples = length;
+	outQuality->snrCentiDb = adc_quality_ratio_centidb(signal, noise);
+	outQuality->sinadCentiDb = adc_quality_ratio_centidb(signal, noise + distortion);
+	outQuality->enobCentiBits = (outQuality->sinadCentiDb - 176) * 100 / 602;
+
+	int64_t amplitude = (int64_t)isqrt64((uint64_t)((int64_t)cosCoeffs[0] * cosCoeffs[0])
+			                           + (uint64_t)((int64_t)sinCoeffs[0] * sinCoeffs[0]));
+	int64_t nominalAmplitude = QUALITY_CODES_Q15(SINE_AMPLITUDE_MV);
+	outQuality->gainErrorPpm = (int32_t)(((amplitude - nominalAmplitude) * 1000000) / nominalAmplitude);
+
+	int64_t offset = meanQ15 - QUALITY_CODES_Q15(SINE_OFFSET_MV);
+	outQuality->offsetErrorUv = (int32_t)((offset * ADC_VREF_MV * 1000) / (1 << (ADC_RESOLUTION_BITS + 15)));
+
+	return buff_err_success;
+}
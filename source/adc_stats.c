@@ -0,0 +1,141 @@
+/*
+ * @file adc_stats.c
+ * @brief Project 6
+ *
+ * @details Converts statistics gathered on raw 12 bit ADC codes to
+ *          millivolts with integer arithmetic, once per report.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "adc_stats.h"
+
+/**
+ * Fraction bits kept on the variance in codes before scaling to mV^2.
+ */
+#define VARIANCE_FRACTION_BITS (16u)
+
+/**
+ * Fraction bits kept on the standard deviation in codes before scaling to mV.
+ */
+#define STDDEV_FRACTION_BITS (8u)
+
+/**
+ * VREF / 4096 mV per code with ADC_MV_SHIFT fractional bits, over 1 + gain error.
+ */
+#define ADC_CAL_SCALE(gainPpm) \
+	((int32_t)(((((int64_t)ADC_VREF_MV << (ADC_MV_SHIFT - ADC_RESOLUTION_BITS)) * 1000000) + \
+	            (1000000 + (gainPpm)) / 2) / (1000000 + (gainPpm))))
+
+/**
+ * Rounding, less the offset referred through the gain, with
+ * ADC_MV_SHIFT fractional bits.
+ */
+#define ADC_CAL_BIAS(gainPpm, offsetUv) \
+	((int32_t)(1 << (ADC_MV_SHIFT - 1)) - \
+	 (int32_t)((((int64_t)(offsetUv) << ADC_MV_SHIFT) * 1000) / (1000000 + (gainPpm))))
+
+#if ADC_CAL_GAIN_PPM > ADC_CAL_MAX_GAIN_PPM || ADC_CAL_GAIN_PPM < -ADC_CAL_MAX_GAIN_PPM || \
+    ADC_CAL_OFFSET_UV > ADC_CAL_MAX_OFFSET_UV || ADC_CAL_OFFSET_UV < -ADC_CAL_MAX_OFFSET_UV
+#error "ADC calibration out of range"
+#endif
+
+/**
+ * The calibration in use, as the scale and bias of every conversion.
+ */
+static int32_t sScale = ADC_CAL_SCALE(ADC_CAL_GAIN_PPM);
+static int32_t sBias = ADC_CAL_BIAS(ADC_CAL_GAIN_PPM, ADC_CAL_OFFSET_UV);
+
+buff_err adc_calibrate(int32_t inGainErrorPpm, int32_t inOffsetErrorUv)
+{
+	if(inGainErrorPpm > ADC_CAL_MAX_GAIN_PPM || inGainErrorPpm < -ADC_CAL_MAX_GAIN_PPM ||
+	   inOffsetErrorUv > ADC_CAL_MAX_OFFSET_UV || inOffsetErrorUv < -ADC_CAL_MAX_OFFSET_UV)
+	{
+		return buff_err_invalid;
+	}
+	sScale = ADC_CAL_SCALE(inGainErrorPpm);
+	sBias = ADC_CAL_BIAS(inGainErrorPpm, inOffsetErrorUv);
+	return buff_err_success;
+}
+
+uint32_t adc_code_to_mv(uint32_t inCode)
+{
+	// 4095 codes at 10 % low gain is under 1.93 * 10^9, and the bias under 1.2 * 10^8
+	int32_t scaled = (int32_t)inCode * sScale + sBias;
+	return scaled < 0 ? 0 : (uint32_t)scaled >> ADC_MV_SHIFT;
+}
+
+uint32_t adc_span_to_mv(uint32_t inCodes)
+{
+	return (inCodes * (uint32_t)sScale + (1u << (ADC_MV_SHIFT - 1))) >> ADC_MV_SHIFT;
+}
+
+uint16_t adc_mv_to_code(uint32_t inMv)
+{
+	// undo the bias, less its rounding half, then divide by the scale to nearest
+	int64_t scaled = ((int64_t)inMv << ADC_MV_SHIFT) - (sBias - (1 << (ADC_MV_SHIFT - 1)));
+	if(scaled <= 0)
+	{
+		return 0;
+	}
+	int64_t code = (scaled + sScale / 2) / sScale;
+	return code > (1 << ADC_RESOLUTION_BITS) - 1 ? (1u << ADC_RESOLUTION_BITS) - 1 : (uint16_t)code;
+}
+
+uint16_t adc_mv_to_span(uint32_t inMv)
+{
+	uint64_t codes = (((uint64_t)inMv << ADC_MV_SHIFT) + (uint32_t)sScale / 2) / (uint32_t)sScale;
+	return codes > (1u << ADC_RESOLUTION_BITS) - 1 ? (1u << ADC_RESOLUTION_BITS) - 1 : (uint16_t)codes;
+}
+
+void adc_block_to_mv(const uint16_t* inCodes, uint16_t* outMv, uint32_t inCount)
+{
+	int32_t scale = sScale;
+	int32_t bias = sBias;
+	for(uint32_t i = 0; i < inCount; i++)
+	{
+		int32_t scaled = (int32_t)inCodes[i] * scale + bias;
+		outMv[i] = scaled < 0 ? 0 : (uint16_t)((uint32_t)scaled >> ADC_MV_SHIFT);
+	}
+}
+
+void adc_stats_report(const stream_stats_t* inStats, adc_stats_report_t* outReport)
+{
+	uint32_t n = inStats->count;
+	outReport->count = n;
+	if(!n)
+	{
+		outReport->minMv = 0;
+		outReport->maxMv = 0;
+		outReport->meanMv = 0;
+		outReport->varianceMv2 = 0;
+		outReport->stdDevMv = 0;
+		return;
+	}
+
+	outReport->minMv = adc_code_to_mv(inStats->min);
+	outReport->maxMv = adc_code_to_mv(inStats->max);
+
+	// codes are non-negative, so the sum is too. sum * scale stays below 2^63
+	// for fewer than 2^31 samples.
+	int64_t scaledSum = inStats->sum * sScale + (int64_t)n * sBias;
+	outReport->meanMv = scaledSum < 0 ? 0 : (uint32_t)(scaledSum / ((int64_t)n << ADC_MV_SHIFT));
+
+	// variance in codes with a binary fraction, then the scale twice into mV^2.
+	// For 12 bit codes it is below 2^38, so each product stays below 2^58.
+	uint64_t varianceCodes = stream_stats_variance_q(inStats, VARIANCE_FRACTION_BITS);
+	uint64_t varianceScaled = (varianceCodes * (uint32_t)sScale) >> ADC_MV_SHIFT;
+	uint32_t shift = VARIANCE_FRACTION_BITS + ADC_MV_SHIFT;
+	outReport->varianceMv2 = (uint32_t)((varianceScaled * (uint32_t)sScale + (1ull << (shift - 1))) >> shift);
+
+	// same for the standard deviation, which is below 2^11 codes
+	uint32_t stdDevCodes = stream_stats_stddev_q(inStats, STDDEV_FRACTION_BITS);
+	shift = STDDEV_FRACTION_BITS + ADC_MV_SHIFT;
+	outReport->stdDevMv = (uint32_t)(((uint64_t)stdDevCodes * (uint32_t)sScale + (1ull << (shift - 1))) >> shift);
+}
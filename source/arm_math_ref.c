@@ -0,0 +1,392 @@
+/*
+ * @file arm_math_ref.c
+ * @brief Project 6
+ *
+ * @details Portable C versions of the CMSIS-DSP kernels this project uses.
+ *          Not built when DSP_STATS_CMSIS_LIBRARY links the real library.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ *
+ *  LEVERAGED API AND FIXED-POINT FORMATS FROM:
+ *  CMSIS DSP Software Library V1.4.5, CMSIS/arm_math.h
+ */
+
+#include "dsp_stats.h"
+
+#if !DSP_STATS_CMSIS_LIBRARY
+
+#include <string.h>
+#include "isqrt.h"
+
+/**
+ * Saturate to the 1.15 range.
+ */
+static q15_t saturate_q15(q31_t inValue)
+{
+	return inValue > INT16_MAX ? INT16_MAX : (inValue < INT16_MIN ? INT16_MIN : (q15_t)inValue);
+}
+
+/**
+ * Saturate to the 1.31 range.
+ */
+static q31_t saturate_q31(q63_t inValue)
+{
+	return inValue > INT32_MAX ? INT32_MAX : (inValue < INT32_MIN ? INT32_MIN : (q31_t)inValue);
+}
+
+void arm_shift_q15(q15_t * pSrc, int8_t shiftBits, q15_t * pDst, uint32_t blockSize)
+{
+	for(uint32_t i = 0; i < blockSize; i++)
+	{
+		q31_t value = pSrc[i];
+		pDst[i] = shiftBits >= 0 ? saturate_q15(value << shiftBits) : (q15_t)(value >> -shiftBits);
+	}
+}
+
+arm_status arm_sqrt_q15(q15_t in, q15_t * pOut)
+{
+	if(in <= 0)
+	{
+		*pOut = 0;
+		return in ? ARM_MATH_ARGUMENT_ERROR : ARM_MATH_SUCCESS;
+	}
+	// sqrt(in / 2^15) * 2^15 = sqrt(in * 2^15)
+	*pOut = (q15_t)isqrt32((uint32_t)in << 15);
+	return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_sqrt_q31(q31_t in, q31_t * pOut)
+{
+	if(in <= 0)
+	{
+		*pOut = 0;
+		return in ? ARM_MATH_ARGUMENT_ERROR : ARM_MATH_SUCCESS;
+	}
+	*pOut = (q31_t)isqrt64((uint64_t)in << 31);
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_max_q15(q15_t * pSrc, uint32_t blockSize, q15_t * pResult, uint32_t * pIndex)
+{
+	q15_t best = pSrc[0];
+	uint32_t index = 0;
+	for(uint32_t i = 1; i < blockSize; i++)
+	{
+		if(pSrc[i] > best)
+		{
+			best = pSrc[i];
+			index = i;
+		}
+	}
+	*pResult = best;
+	*pIndex = index;
+}
+
+void arm_max_q31(q31_t * pSrc, uint32_t blockSize, q31_t * pResult, uint32_t * pIndex)
+{
+	q31_t best = pSrc[0];
+	uint32_t index = 0;
+	for(uint32_t i = 1; i < blockSize; i++)
+	{
+		if(pSrc[i] > best)
+		{
+			best = pSrc[i];
+			index = i;
+		}
+	}
+	*pResult = best;
+	*pIndex = index;
+}
+
+void arm_min_q15(q15_t * pSrc, uint32_t blockSize, q15_t * pResult, uint32_t * pIndex)
+{
+	q15_t best = pSrc[0];
+	uint32_t index = 0;
+	for(uint32_t i = 1; i < blockSize; i++)
+	{
+		if(pSrc[i] < best)
+		{
+			best = pSrc[i];
+			index = i;
+		}
+	}
+	*pResult = best;
+	*pIndex = index;
+}
+
+void arm_min_q31(q31_t * pSrc, uint32_t blockSize, q31_t * pResult, uint32_t * pIndex)
+{
+	q31_t best = pSrc[0];
+	uint32_t index = 0;
+	for(uint32_t i = 1; i < blockSize; i++)
+	{
+		if(pSrc[i] < best)
+		{
+			best = pSrc[i];
+			index = i;
+		}
+	}
+	*pResult = best;
+	*pIndex = index;
+}
+
+void arm_mean_q15(q15_t * pSrc, uint32_t blockSize, q15_t * pResult)
+{
+	q31_t sum = 0;
+	for(uint32_t i = 0; i < blockSize; i++)
+	{
+		sum += pSrc[i];
+	}
+	*pResult = (q15_t)(sum / (q31_t)blockSize);
+}
+
+void arm_mean_q31(q31_t * pSrc, uint32_t blockSize, q31_t * pResult)
+{
+	q63_t sum = 0;
+	for(uint32_t i = 0; i < blockSize; i++)
+	{
+		sum += pSrc[i];
+	}
+	*pResult = (q31_t)(sum / (q63_t)blockSize);
+}
+
+void arm_std_q15(q15_t * pSrc, uint32_t blockSize, q15_t * pResult)
+{
+	if(blockSize < 2)
+	{
+		*pResult = 0;
+		return;
+	}
+
+	// sum in 17.15, squares in 34.30
+	q31_t sum = 0;
+	q63_t sumOfSquares = 0;
+	for(uint32_t i = 0; i < blockSize; i++)
+	{
+		q31_t in = pSrc[i];
+		sum += in;
+		sumOfSquares += in * in;
+	}
+
+	q31_t meanOfSquares = (q31_t)(sumOfSquares / (q63_t)(blockSize - 1));
+	q31_t squareOfMean = (q31_t)((q63_t)sum * sum / (q63_t)((q63_t)blockSize * (blockSize - 1)));
+	arm_sqrt_q15(saturate_q15((meanOfSquares - squareOfMean) >> 15), pResult);
+}
+
+void arm_std_q31(q31_t * pSrc, uint32_t blockSize, q31_t * pResult)
+{
+	if(blockSize < 2)
+	{
+		*pResult = 0;
+		return;
+	}
+
+	// inputs are scaled to 1.23 first so the squares cannot overflow 64 bits
+	q63_t sum = 0;
+	q63_t sumOfSquares = 0;
+	for(uint32_t i = 0; i < blockSize; i++)
+	{
+		q31_t in = pSrc[i] >> 8;
+		sum += in;
+		sumOfSquares += (q63_t)in * in;
+	}
+
+	// as in the library, sum * sum limits full-scale input to about 360 samples
+	q63_t meanOfSquares = sumOfSquares / (q63_t)(blockSize - 1);
+	q63_t squareOfMean = sum * sum / (q63_t)((q63_t)blockSize * (blockSize - 1));
+	// 2.46 back to 1.31
+	arm_sqrt_q31(saturate_q31((meanOfSquares - squareOfMean) >> 15), pResult);
+}
+
+void arm_rms_q15(q15_t * pSrc, uint32_t blockSize, q15_t * pResult)
+{
+	q63_t sumOfSquares = 0;
+	for(uint32_t i = 0; i < blockSize; i++)
+	{
+		q31_t in = pSrc[i];
+		sumOfSquares += in * in;
+	}
+	arm_sqrt_q15(saturate_q15((q31_t)((sumOfSquares / (q63_t)blockSize) >> 15)), pResult);
+}
+
+void arm_rms_q31(q31_t * pSrc, uint32_t blockSize, q31_t * pResult)
+{
+	// squares in 2.62, shifted to 2.48 so the sum has headroom
+	q63_t sumOfSquares = 0;
+	for(uint32_t i = 0; i < blockSize; i++)
+	{
+		sumOfSquares += ((q63_t)pSrc[i] * pSrc[i]) >> 14;
+	}
+	arm_sqrt_q31(saturate_q31((sumOfSquares / (q63_t)blockSize) >> 17), pResult);
+}
+
+void arm_q15_to_q31(q15_t * pSrc, q31_t * pDst, uint32_t blockSize)
+{
+	for(uint32_t i = 0; i < blockSize; i++)
+	{
+		pDst[i] = (q31_t)pSrc[i] << 16;
+	}
+}
+
+void arm_q31_to_q15(q31_t * pSrc, q15_t * pDst, uint32_t blockSize)
+{
+	for(uint32_t i = 0; i < blockSize; i++)
+	{
+		pDst[i] = (q15_t)(pSrc[i] >> 16);
+	}
+}
+
+void arm_biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 * S, uint8_t numStages,
+		q15_t * pCoeffs, q15_t * pState, int8_t postShift)
+{
+	S->numStages = (int8_t)numStages;
+	S->pCoeffs = pCoeffs;
+	S->postShift = postShift;
+	S->pState = pState;
+	memset(pState, 0, 4u * numStages * sizeof(q15_t));
+}
+
+void arm_biquad_cascade_df1_q15(const arm_biquad_casd_df1_inst_q15 * S, q15_t * pSrc,
+		q15_t * pDst, uint32_t blockSize)
+{
+	const q15_t* coeffs = S->pCoeffs;
+	q15_t* state = S->pState;
+	int32_t shift = 15 - S->postShift;
+
+	// each stage reads the one before it in place, so pSrc may be pDst
+	q15_t* in = pSrc;
+	for(int32_t stage = 0; stage < S->numStages; stage++)
+	{
+		q31_t b0 = coeffs[0];
+		q31_t b1 = coeffs[2];
+		q31_t b2 = coeffs[3];
+		q31_t a1 = coeffs[4];
+		q31_t a2 = coeffs[5];
+		q15_t x1 = state[0];
+		q15_t x2 = state[1];
+		q15_t y1 = state[2];
+		q15_t y2 = state[3];
+
+		for(uint32_t i = 0; i < blockSize; i++)
+		{
+			q15_t x0 = in[i];
+			// every product fits 32 bits; only the sum needs 64
+			q63_t acc = (q63_t)(b0 * x0) + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2;
+			q15_t y0 = saturate_q15((q31_t)saturate_q31(acc >> shift));
+			x2 = x1;
+			x1 = x0;
+			y2 = y1;
+			y1 = y0;
+			pDst[i] = y0;
+		}
+
+		state[0] = x1;
+		state[1] = x2;
+		state[2] = y1;
+		state[3] = y2;
+		coeffs += 6;
+		state += 4;
+		in = pDst;
+	}
+}
+
+void arm_biquad_cascade_df1_init_q31(arm_biquad_casd_df1_inst_q31 * S, uint8_t numStages,
+		q31_t * pCoeffs, q31_t * pState, int8_t postShift)
+{
+	S->numStages = numStages;
+	S->pCoeffs = pCoeffs;
+	S->postShift = (uint8_t)postShift;
+	S->pState = pState;
+	memset(pState, 0, 4u * numStages * sizeof(q31_t));
+}
+
+void arm_biquad_cascade_df1_q31(const arm_biquad_casd_df1_inst_q31 * S, q31_t * pSrc,
+		q31_t * pDst, uint32_t blockSize)
+{
+	const q31_t* coeffs = S->pCoeffs;
+	q31_t* state = S->pState;
+	int32_t shift = 31 - S->postShift;
+
+	q31_t* in = pSrc;
+	for(uint32_t stage = 0; stage < S->numStages; stage++)
+	{
+		q31_t b0 = coeffs[0];
+		q31_t b1 = coeffs[1];
+		q31_t b2 = coeffs[2];
+		q31_t a1 = coeffs[3];
+		q31_t a2 = coeffs[4];
+		q31_t x1 = state[0];
+		q31_t x2 = state[1];
+		q31_t y1 = state[2];
+		q31_t y2 = state[3];
+
+		for(uint32_t i = 0; i < blockSize; i++)
+		{
+			q31_t x0 = in[i];
+			q63_t acc = (q63_t)b0 * x0 + (q63_t)b1 * x1 + (q63_t)b2 * x2
+					  + (q63_t)a1 * y1 + (q63_t)a2 * y2;
+			q31_t y0 = (q31_t)(acc >> shift);
+			x2 = x1;
+			x1 = x0;
+			y2 = y1;
+			y1 = y0;
+			pDst[i] = y0;
+		}
+
+		state[0] = x1;
+		state[1] = x2;
+		state[2] = y1;
+		state[3] = y2;
+		coeffs += 5;
+		state += 4;
+		in = pDst;
+	}
+}
+
+arm_status arm_fir_init_q15(arm_fir_instance_q15 * S, uint16_t numTaps, q15_t * pCoeffs,
+		q15_t * pState, uint32_t blockSize)
+{
+	if(!numTaps)
+	{
+		return ARM_MATH_ARGUMENT_ERROR;
+	}
+	S->numTaps = numTaps;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (numTaps + blockSize - 1u) * sizeof(q15_t));
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_fir_q15(const arm_fir_instance_q15 * S, q15_t * pSrc, q15_t * pDst, uint32_t blockSize)
+{
+	uint32_t numTaps = S->numTaps;
+	const q15_t* coeffs = S->pCoeffs;
+
+	/**
+	 * The last numTaps - 1 inputs of the previous call lead the state, and
+	 * this block is copied in after them, each sample before its output is
+	 * written, so pSrc may be pDst.
+	 */
+	q15_t* history = S->pState + numTaps - 1u;
+	for(uint32_t i = 0; i < blockSize; i++)
+	{
+		history[i] = pSrc[i];
+		const q15_t* window = S->pState + i;
+		q63_t acc = 0;
+		for(uint32_t k = 0; k < numTaps; k++)
+		{
+			acc += (q31_t)window[k] * coeffs[k];
+		}
+		pDst[i] = saturate_q15((q31_t)saturate_q31(acc >> 15));
+	}
+
+	memmove(S->pState, S->pState + blockSize, (numTaps - 1u) * sizeof(q15_t));
+}
+
+#endif
@@ -0,0 +1,263 @@
+/*
+ * @file broadcast_ring.c
+ * @brief Project 6
+ *
+ * @details A single-writer ring of 16 bit samples read by several consumers.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "broadcast_ring.h"
+#include "spsc_ring.h"
+
+/**
+ * Keep the sample load ahead of the head reload that validates it.
+ */
+#define BROADCAST_READ_FENCE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+
+/**
+ * Unread samples behind head for the slowest attached reader. An overrun
+ * reader counts as a full ring.
+ */
+static uint32_t slowestUsed(broadcast_ring_t* inRing, uint32_t inHead, uint32_t inAttached)
+{
+	uint32_t capacity = inRing->mask + 1;
+	uint32_t used = 0;
+	for(size_t i = 0; inAttached; i++, inAttached >>= 1)
+	{
+		if(inAttached & 1)
+		{
+			uint32_t readerUsed = inHead - SPSC_LOAD_ACQUIRE(&inRing->tails[i]);
+			if(readerUsed > used)
+			{
+				used = readerUsed;
+			}
+		}
+	}
+	return used > capacity ? capacity : used;
+}
+
+/**
+ * Most unread samples a reader can trust. When overwriting, the writer
+ * stores into the slot of sample head - capacity before it publishes
+ * head + 1, so that sample may already be gone.
+ */
+static inline uint32_t readable(const broadcast_ring_t* inRing)
+{
+	return inRing->policy == cbuf_policy_overwrite ? inRing->mask : inRing->mask + 1;
+}
+
+/**
+ * Move an overrun reader up to the oldest sample still in the ring.
+ * Returns the reader's (possibly moved) read index.
+ */
+static uint32_t resync(broadcast_ring_t* inRing, size_t inReader, uint32_t inTail, uint32_t inHead)
+{
+	uint32_t limit = readable(inRing);
+	if(inHead - inTail > limit)
+	{
+		inRing->lost[inReader] += inHead - inTail - limit;
+		inTail = inHead - limit;
+		SPSC_STORE_RELEASE(&inRing->tails[inReader], inTail);
+	}
+	return inTail;
+}
+
+buff_err broadcast_ring_init(broadcast_ring_t* outRing, uint16_t* inStorage, size_t inCapacity,
+		                     cbuf_policy inPolicy)
+{
+	if(!outRing || !inStorage || !inCapacity ||
+	   (inCapacity & (inCapacity - 1)) || inCapacity > 0x80000000u ||
+	   (inPolicy == cbuf_policy_overwrite && inCapacity < 2))
+	{
+		return buff_err_invalid;
+	}
+
+	outRing->buffer = inStorage;
+	outRing->mask = (uint32_t)(inCapacity - 1);
+	outRing->policy = inPolicy;
+	outRing->head = 0;
+	outRing->attached = 0;
+	outRing->seenAttached = 0;
+	outRing->space = (uint32_t)inCapacity;
+	for(size_t i = 0; i < BROADCAST_RING_MAX_READERS; i++)
+	{
+		outRing->tails[i] = 0;
+		outRing->lost[i] = 0;
+	}
+	RING_STATS_CLEAR(outRing);
+	return buff_err_success;
+}
+
+buff_err broadcast_ring_attach(broadcast_ring_t* inRing, size_t* outReader)
+{
+	uint32_t attached = inRing->attached;
+	for(size_t i = 0; i < BROADCAST_RING_MAX_READERS; i++)
+	{
+		if(!(attached & (1u << i)))
+		{
+			inRing->lost[i] = 0;
+			inRing->tails[i] = SPSC_LOAD_ACQUIRE(&inRing->head);
+			// the tail must be in place before the writer can see the reader
+			SPSC_STORE_RELEASE(&inRing->attached, attached | (1u << i));
+			*outReader = i;
+			return buff_err_success;
+		}
+	}
+	return buff_err_full;
+}
+
+void broadcast_ring_detach(broadcast_ring_t* inRing, size_t inReader)
+{
+	if(inReader < BROADCAST_RING_MAX_READERS)
+	{
+		SPSC_STORE_RELEASE(&inRing->attached, inRing->attached & ~(1u << inReader));
+	}
+}
+
+buff_err broadcast_ring_push(broadcast_ring_t* inRing, uint16_t inSample)
+{
+	buff_err err = buff_err_success;
+	uint32_t head = inRing->head;
+	uint32_t attached = SPSC_LOAD_ACQUIRE(&inRing->attached);
+
+	// only walk the readers when the cached space runs out or they change
+	if(!inRing->space || attached != inRing->seenAttached)
+	{
+		inRing->space = inRing->mask + 1 - slowestUsed(inRing, head, attached);
+		inRing->seenAttached = attached;
+	}
+
+	if(inRing->space)
+	{
+		inRing->space--;
+	}
+	else
+	{
+		err = buff_err_full;
+		if(inRing->policy == cbuf_policy_reject)
+		{
+			RING_STATS_ADD(inRing, rejected, 1);
+			return err;
+		}
+		RING_STATS_ADD(inRing, overwrites, 1);
+	}
+
+	inRing->buffer[head & inRing->mask] = inSample;
+	SPSC_STORE_RELEASE(&inRing->head, head + 1);
+	RING_STATS_ADD(inRing, pushes, 1);
+	RING_STATS_PEAK(inRing, inRing->mask + 1 - inRing->space);
+	return err;
+}
+
+buff_err broadcast_ring_pop(broadcast_ring_t* inRing, size_t inReader, uint16_t* outSample)
+{
+	if(inReader >= BROADCAST_RING_MAX_READERS || !outSample)
+	{
+		return buff_err_invalid;
+	}
+
+	uint32_t tail = inRing->tails[inReader];
+	for(;;)
+	{
+		uint32_t head = SPSC_LOAD_ACQUIRE(&inRing->head);
+		if(head == tail)
+		{
+			return buff_err_empty;
+		}
+		tail = resync(inRing, inReader, tail, head);
+
+		uint16_t sample = inRing->buffer[tail & inRing->mask];
+		BROADCAST_READ_FENCE();
+		// the writer may have lapped us while we read the slot
+		if(SPSC_LOAD_ACQUIRE(&inRing->head) - tail <= readable(inRing))
+		{
+			*outSample = sample;
+			SPSC_STORE_RELEASE(&inRing->tails[inReader], tail + 1);
+			return buff_err_success;
+		}
+	}
+}
+
+size_t broadcast_ring_peek_read(broadcast_ring_t* inRing, size_t inReader,
+		                        broadcast_span_t outSpans[2])
+{
+	if(inReader >= BROADCAST_RING_MAX_READERS)
+	{
+		return 0;
+	}
+
+	uint32_t head = SPSC_LOAD_ACQUIRE(&inRing->head);
+	uint32_t tail = resync(inRing, inReader, inRing->tails[inReader], head);
+	uint32_t capacity = inRing->mask + 1;
+	uint32_t used = head - tail;
+	uint32_t start = tail & inRing->mask;
+	uint32_t first = capacity - start;
+	if(first > used)
+	{
+		first = used;
+	}
+
+	outSpans[0].data = inRing->buffer + start;
+	outSpans[0].count = first;
+	outSpans[1].data = inRing->buffer;
+	outSpans[1].count = used - first;
+	return used;
+}
+
+buff_err broadcast_ring_commit_read(broadcast_ring_t* inRing, size_t inReader, size_t inCount)
+{
+	if(inReader >= BROADCAST_RING_MAX_READERS)
+	{
+		return buff_err_invalid;
+	}
+
+	uint32_t tail = inRing->tails[inReader];
+	uint32_t head = SPSC_LOAD_ACQUIRE(&inRing->head);
+	if(head - tail > readable(inRing))
+	{
+		// what was peeked has been partly overwritten
+		resync(inRing, inReader, tail, head);
+		return buff_err_full;
+	}
+	if(inCount > head - tail)
+	{
+		return buff_err_invalid;
+	}
+
+	SPSC_STORE_RELEASE(&inRing->tails[inReader], tail + (uint32_t)inCount);
+	return buff_err_success;
+}
+
+size_t broadcast_ring_size(broadcast_ring_t* inRing, size_t inReader)
+{
+	if(inReader >= BROADCAST_RING_MAX_READERS)
+	{
+		return 0;
+	}
+
+	uint32_t used = SPSC_LOAD_ACQUIRE(&inRing->head) - inRing->tails[inReader];
+	return used > readable(inRing) ? readable(inRing) : used;
+}
+
+size_t broadcast_ring_slowest(broadcast_ring_t* inRing)
+{
+	return slowestUsed(inRing, SPSC_LOAD_ACQUIRE(&inRing->head),
+			           SPSC_LOAD_ACQUIRE(&inRing->attached));
+}
+
+uint32_t broadcast_ring_lost(broadcast_ring_t* inRing, size_t inReader)
+{
+	return inReader < BROADCAST_RING_MAX_READERS ? inRing->lost[inReader] : 0;
+}
+
+size_t broadcast_ring_capacity(broadcast_ring_t* inRing)
+{
+	return inRing->mask + 1;
+}
@@ -23,6 +23,7 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <string.h>
 
 /**
  * ABS
@@ -34,40 +35,32 @@
 #define ABS(x) ((x)>0?(x):-(x))
 
 /**
- * @brief List node for keeping track of owned buffers
+ * @brief Tag stored in every live descriptor. Cleared when the buffer is freed.
  */
-struct mem_list_node
-{
-	circular_buf_t* data;
-	size_t size;
-	struct mem_list_node* next;
-};
+#define CIRCULAR_BUF_MAGIC (0xCB0FCB0Fu)
 
-// sentinel struct, always has null data
-static struct mem_list_node memListHead = { NULL, 0, NULL };
+/**
+ * @brief Descriptors for circular_buf_init_static. A slot is free when its
+ *        magic word is not set.
+ */
+#if CIRCULAR_BUF_POOL_SIZE
+static circular_buf_t sDescriptorPool[CIRCULAR_BUF_POOL_SIZE];
+#endif
 
 /**
  * @brief Whether the given handle is owned currently or null or garbage.
+ * @details Constant time: checks the magic word instead of walking a list
+ *          of every live buffer.
  * @param inHandle Handle to check.
  * @return
  */
 bool bufferIsOwned(cbuf_handle_t inHandle)
 {
-	circular_buf_t* buffer = (circular_buf_t*)inHandle;
-	if(buffer)
-	{
-		// try and see if the requested location resides in owned memory
-		struct mem_list_node* iter = &memListHead;
-		while (iter)
-		{
-			if(iter->data == buffer)
-			{
-				return true;
-			}
-			iter = iter->next;
-		}
-	}
-	return false;
+#if CIRCULAR_BUF_CHECKS
+	return inHandle && (inHandle->magic == CIRCULAR_BUF_MAGIC);
+#else
+	return inHandle != NULL;
+#endif
 }
 
 void circular_buf_reset(cbuf_handle_t inBufHandle)
@@ -95,50 +88,70 @@ cbuf_handle_t circular_buf_init(size_t inSize)
 {
 	assert(inSize);
 
-	struct mem_list_node* iter = &memListHead;
+	circular_buf_t* buffer = (circular_buf_t*)malloc(sizeof(circular_buf_t));
+	assert(buffer);
+
+	buffer->buffer = (uint32_t*)malloc(sizeof(uint32_t)*inSize);
+	assert(buffer->buffer);
+	buffer->max = inSize;
+	buffer->write = 0;
+	buffer->read = 0;
+	buffer->full = false;
+	buffer->isStatic = false;
+	buffer->policy = cbuf_policy_overwrite;
+#if RING_STATS
+	memset(&buffer->stats, 0, sizeof(buffer->stats));
+#endif
+	buffer->magic = CIRCULAR_BUF_MAGIC;
+
+	assert(circular_buf_empty(buffer));
+	return buffer;
+}
+
+cbuf_handle_t circular_buf_init_static(uint32_t * inStorage, size_t inSize)
+{
+	assert(inStorage);
+	assert(inSize);
 
-	while(iter->next)
+#if CIRCULAR_BUF_POOL_SIZE
+	for(size_t i = 0; i < CIRCULAR_BUF_POOL_SIZE; i++)
 	{
-		iter = iter->next;
+		circular_buf_t* buffer = &sDescriptorPool[i];
+		if(buffer->magic != CIRCULAR_BUF_MAGIC)
+		{
+			buffer->buffer = inStorage;
+			buffer->max = inSize;
+			buffer->write = 0;
+			buffer->read = 0;
+			buffer->full = false;
+			buffer->isStatic = true;
+			buffer->policy = cbuf_policy_overwrite;
+#if RING_STATS
+			memset(&buffer->stats, 0, sizeof(buffer->stats));
+#endif
+			buffer->magic = CIRCULAR_BUF_MAGIC;
+			return buffer;
+		}
 	}
-	iter->next = (struct mem_list_node*)malloc(sizeof(struct mem_list_node));
-
-	iter->next->data = (circular_buf_t*)malloc(sizeof(circular_buf_t));
-
-	assert(iter->next->data);
+#endif
 
-	iter->next->data->buffer = (uint32_t*)malloc(sizeof(uint32_t)*inSize);
-	assert(iter->next->data->buffer);
-	iter->next->data->max = inSize;
-	iter->next->data->write = 0;
-	iter->next->data->read = 0;
-	iter->next->data->full = false;
-
-	iter->next->next = NULL;
-
-	assert(circular_buf_empty(iter->next->data));
-	return iter->next->data;
+	// pool exhausted, raise CIRCULAR_BUF_POOL_SIZE
+	return NULL;
 }
 
 void circular_buf_free(cbuf_handle_t inBufHandle)
 {
-	circular_buf_t* buffer = (circular_buf_t*)inBufHandle;
-	if(buffer)
+	if(bufferIsOwned(inBufHandle))
 	{
-		struct mem_list_node* iter = &memListHead;
-
-		while (iter->next)
+		// invalidate before releasing so stale handles are rejected
+		inBufHandle->magic = 0;
+#if RING_STATS
+		ring_stats_unregister(&inBufHandle->stats);
+#endif
+		if(!inBufHandle->isStatic)
 		{
-			if(iter->next->data == buffer)
-			{
-				free(buffer->buffer);
-				free(buffer);
-				struct mem_list_node* node_to_delete = iter->next;
-				iter->next = iter->next->next;
-				free(node_to_delete);
-				return;
-			}
-			iter = iter->next;
+			free(inBufHandle->buffer);
+			free(inBufHandle);
 		}
 	}
 }
@@ -147,17 +160,24 @@ buff_err circular_buf_resize(cbuf_handle_t* inOutBufHandle, size_t inSize)
 {
 	if(inOutBufHandle &&
 	   bufferIsOwned(*inOutBufHandle) &&
+	   !(*inOutBufHandle)->isStatic &&
 	   inSize > circular_buf_size(*inOutBufHandle))
 	{
 		// create new buffer
 		cbuf_handle_t newBuf = circular_buf_init(inSize);
 
-		// copy contents from old buffer
-		uint32_t ch;
-		while(circular_buf_pop(*inOutBufHandle, &ch) == buff_err_success)
-		{
-			circular_buf_push(newBuf, ch);
-		}
+		// copy contents from old buffer, one memcpy per span
+		cbuf_span_t spans[2];
+		circular_buf_peek_read(*inOutBufHandle, spans);
+		circular_buf_push_n(newBuf, spans[0].data, spans[0].count, NULL);
+		circular_buf_push_n(newBuf, spans[1].data, spans[1].count, NULL);
+
+		// keep the policy and counters across the resize
+		newBuf->policy = (*inOutBufHandle)->policy;
+#if RING_STATS
+		// overwrites the counts from the copy above, which was not new traffic
+		ring_stats_move(&(*inOutBufHandle)->stats, &newBuf->stats);
+#endif
 
 		// free old buffer
 		circular_buf_free(*inOutBufHandle);
@@ -170,22 +190,39 @@ buff_err circular_buf_resize(cbuf_handle_t* inOutBufHandle, size_t inSize)
 	return buff_err_invalid;
 }
 
+void circular_buf_set_policy(cbuf_handle_t inBufHandle, cbuf_policy inPolicy)
+{
+	if(bufferIsOwned(inBufHandle))
+	{
+		inBufHandle->policy = inPolicy;
+	}
+}
+
 buff_err circular_buf_push(cbuf_handle_t inBufHandle, uint32_t inData)
 {
 	buff_err err = buff_err_success;
 
 	if(bufferIsOwned(inBufHandle))
 	{
-		inBufHandle->buffer[inBufHandle->write] = inData;
 		if(inBufHandle->full)
 		{
+			err = buff_err_full; // alert about wrap or rejection
+			if(inBufHandle->policy == cbuf_policy_reject)
+			{
+				RING_STATS_ADD(inBufHandle, rejected, 1);
+				return err;
+			}
+
 			// wrap
 			inBufHandle->read = (inBufHandle->read + 1) % inBufHandle->max;
-			err = buff_err_full; // won't fail, just alert about wrap
+			RING_STATS_ADD(inBufHandle, overwrites, 1);
 		}
+		inBufHandle->buffer[inBufHandle->write] = inData;
 
 		inBufHandle->write = (inBufHandle->write + 1) % inBufHandle->max;
 		inBufHandle->full = (inBufHandle->write == inBufHandle->read);
+		RING_STATS_ADD(inBufHandle, pushes, 1);
+		RING_STATS_PEAK(inBufHandle, circular_buf_size(inBufHandle));
 	}
 	else
 	{
@@ -219,6 +256,8 @@ buff_err circular_buf_push_resize(cbuf_handle_t* inOutBufHandle, uint32_t inData
 
 			inBufHandle->write = (inBufHandle->write + 1) % inBufHandle->max;
 			inBufHandle->full = (inBufHandle->write == inBufHandle->read);
+			RING_STATS_ADD(inBufHandle, pushes, 1);
+			RING_STATS_PEAK(inBufHandle, circular_buf_size(inBufHandle));
 			err = buff_err_success;
 
 		}
@@ -238,11 +277,156 @@ buff_err circular_buf_pop(cbuf_handle_t inBufHandle, uint32_t * outData)
 		*outData = inBufHandle->buffer[inBufHandle->read];
 		inBufHandle->full = false;
 		inBufHandle->read = (inBufHandle->read + 1) % inBufHandle->max;
+		RING_STATS_ADD(inBufHandle, pops, 1);
 		err = buff_err_success;
 	}
 	return err;
 }
 
+size_t circular_buf_peek_read(cbuf_handle_t inBufHandle, cbuf_span_t outSpans[2])
+{
+	outSpans[0].data = NULL;
+	outSpans[0].count = 0;
+	outSpans[1].data = NULL;
+	outSpans[1].count = 0;
+
+	if(!bufferIsOwned(inBufHandle))
+	{
+		return 0;
+	}
+
+	size_t size = circular_buf_size(inBufHandle);
+	size_t toEnd = inBufHandle->max - inBufHandle->read;
+
+	outSpans[0].data = &inBufHandle->buffer[inBufHandle->read];
+	outSpans[0].count = (size < toEnd) ? size : toEnd;
+	outSpans[1].data = inBufHandle->buffer;
+	outSpans[1].count = size - outSpans[0].count;
+
+	return size;
+}
+
+buff_err circular_buf_commit_read(cbuf_handle_t inBufHandle, size_t inCount)
+{
+	if(!bufferIsOwned(inBufHandle) || inCount > circular_buf_size(inBufHandle))
+	{
+		return buff_err_invalid;
+	}
+
+	if(inCount)
+	{
+		inBufHandle->read = (inBufHandle->read + inCount) % inBufHandle->max;
+		inBufHandle->full = false;
+		RING_STATS_ADD(inBufHandle, pops, inCount);
+	}
+	return buff_err_success;
+}
+
+size_t circular_buf_peek_write(cbuf_handle_t inBufHandle, cbuf_span_t outSpans[2])
+{
+	outSpans[0].data = NULL;
+	outSpans[0].count = 0;
+	outSpans[1].data = NULL;
+	outSpans[1].count = 0;
+
+	if(!bufferIsOwned(inBufHandle))
+	{
+		return 0;
+	}
+
+	size_t space = inBufHandle->max - circular_buf_size(inBufHandle);
+	size_t toEnd = inBufHandle->max - inBufHandle->write;
+
+	outSpans[0].data = &inBufHandle->buffer[inBufHandle->write];
+	outSpans[0].count = (space < toEnd) ? space : toEnd;
+	outSpans[1].data = inBufHandle->buffer;
+	outSpans[1].count = space - outSpans[0].count;
+
+	return space;
+}
+
+buff_err circular_buf_commit_write(cbuf_handle_t inBufHandle, size_t inCount)
+{
+	if(!bufferIsOwned(inBufHandle) ||
+	   inCount > inBufHandle->max - circular_buf_size(inBufHandle))
+	{
+		return buff_err_invalid;
+	}
+
+	if(inCount)
+	{
+		inBufHandle->write = (inBufHandle->write + inCount) % inBufHandle->max;
+		inBufHandle->full = (inBufHandle->write == inBufHandle->read);
+		RING_STATS_ADD(inBufHandle, pushes, inCount);
+		RING_STATS_PEAK(inBufHandle, circular_buf_size(inBufHandle));
+	}
+	return buff_err_success;
+}
+
+buff_err circular_buf_push_n(cbuf_handle_t inBufHandle, const uint32_t * inData,
+		                     size_t inCount, size_t * outCount)
+{
+	if(outCount)
+	{
+		*outCount = 0;
+	}
+
+	if(!bufferIsOwned(inBufHandle))
+	{
+		return buff_err_invalid;
+	}
+
+	cbuf_span_t spans[2];
+	size_t space = circular_buf_peek_write(inBufHandle, spans);
+	size_t count = (inCount < space) ? inCount : space;
+	size_t first = (count < spans[0].count) ? count : spans[0].count;
+
+	memcpy(spans[0].data, inData, first * sizeof(uint32_t));
+	memcpy(spans[1].data, inData + first, (count - first) * sizeof(uint32_t));
+	circular_buf_commit_write(inBufHandle, count);
+	RING_STATS_ADD(inBufHandle, rejected, inCount - count);
+
+	if(outCount)
+	{
+		*outCount = count;
+	}
+	return (count == inCount) ? buff_err_success : buff_err_full;
+}
+
+buff_err circular_buf_pop_n(cbuf_handle_t inBufHandle, uint32_t * outData,
+		                    size_t inCount, size_t * outCount)
+{
+	if(outCount)
+	{
+		*outCount = 0;
+	}
+
+	if(!bufferIsOwned(inBufHandle))
+	{
+		return buff_err_invalid;
+	}
+
+	cbuf_span_t spans[2];
+	size_t size = circular_buf_peek_read(inBufHandle, spans);
+	if(size == 0)
+	{
+		return buff_err_empty;
+	}
+
+	size_t count = (inCount < size) ? inCount : size;
+	size_t first = (count < spans[0].count) ? count : spans[0].count;
+
+	memcpy(outData, spans[0].data, first * sizeof(uint32_t));
+	memcpy(outData + first, spans[1].data, (count - first) * sizeof(uint32_t));
+	circular_buf_commit_read(inBufHandle, count);
+
+	if(outCount)
+	{
+		*outCount = count;
+	}
+	return buff_err_success;
+}
+
 bool circular_buf_empty(cbuf_handle_t inBufHandle)
 {
 	assert(bufferIsOwned(inBufHandle));
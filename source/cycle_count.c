@@ -0,0 +1,41 @@
+/*
+ * @file cycle_count.c
+ * @brief Project 6
+ *
+ * @details A free-running CPU cycle counter for profiling on the KL25Z.
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "cycle_count.h"
+#include "MKL25Z4.h"
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+uint32_t cycle_count_now()
+{
+	TickType_t ticks;
+	uint32_t val;
+
+	// re-read if a tick landed between the two reads
+	do
+	{
+		ticks = xTaskGetTickCount();
+		val = SysTick->VAL;
+	} while(ticks != xTaskGetTickCount());
+
+	uint32_t reload = SysTick->LOAD;
+	return (uint32_t)ticks * (reload + 1) + (reload - val);
+}
+
+uint32_t cycle_count_to_us(uint32_t inCycles)
+{
+	return inCycles / (SystemCoreClock / 1000000);
+}
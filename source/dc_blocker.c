@@ -0,0 +1,59 @@
+/*
+ * @file dc_blocker.c
+ * @brief Project 6
+ *
+ * @details DC blocking filter with error feedback.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "dc_blocker.h"
+
+void dc_blocker_init(dc_blocker_t* inBlocker, q15_t inPole, q15_t inOffset)
+{
+	inBlocker->pole = inPole;
+	inBlocker->offset = inOffset;
+	inBlocker->x1 = 0;
+	inBlocker->y1 = 0;
+	inBlocker->error = 0;
+}
+
+void dc_blocker_prime(dc_blocker_t* inBlocker, q15_t inSample)
+{
+	inBlocker->x1 = inSample;
+	inBlocker->y1 = 0;
+	inBlocker->error = 0;
+}
+
+void dc_blocker_q15(dc_blocker_t* inBlocker, q15_t* ioBlock, uint32_t inCount)
+{
+	int32_t pole = inBlocker->pole;
+	int32_t offset = inBlocker->offset;
+	int32_t x1 = inBlocker->x1;
+	int32_t y1 = inBlocker->y1;
+	int32_t error = inBlocker->error;
+
+	for(uint32_t n = 0; n < inCount; n++)
+	{
+		int32_t x0 = ioBlock[n];
+		// one 32 bit multiply; the sum stays within 2^31 for inputs within 2^14
+		int32_t acc = (x0 - x1) * (1 << 15) + pole * y1 + error;
+		int32_t y0 = acc >> 15;
+		error = acc - y0 * (1 << 15);
+		x1 = x0;
+		y1 = y0;
+
+		int32_t out = y0 + offset;
+		ioBlock[n] = out > INT16_MAX ? INT16_MAX : (out < INT16_MIN ? INT16_MIN : (q15_t)out);
+	}
+
+	inBlocker->x1 = (q15_t)x1;
+	inBlocker->y1 = y1;
+	inBlocker->error = error;
+}
@@ -0,0 +1,87 @@
+/*
+ * @file decimator.c
+ * @brief Project 6
+ *
+ * @details CIC decimator with a compensating FIR.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "decimator.h"
+
+/**
+ * The compensator's outer taps, -order / 24, in 1.15. The centre tap is
+ * 1 minus twice this, so the taps sum to exactly 1.0 and DC passes unchanged.
+ */
+#define DECIMATOR_COMP_OUTER (-(DECIMATOR_CIC_ORDER * 32768 + 12) / 24)
+#define DECIMATOR_COMP_CENTRE (32768 - 2 * DECIMATOR_COMP_OUTER)
+
+buff_err decimator_init(decimator_t* inDecimator, uint32_t inRatio)
+{
+	if(!inDecimator || !inRatio || inRatio > DECIMATOR_MAX_RATIO)
+	{
+		return buff_err_invalid;
+	}
+
+	inDecimator->ratio = inRatio;
+	inDecimator->gain = 1;
+	for(uint32_t stage = 0; stage < DECIMATOR_CIC_ORDER; stage++)
+	{
+		inDecimator->integrators[stage] = 0;
+		inDecimator->combs[stage] = 0;
+		inDecimator->gain *= inRatio;
+	}
+	inDecimator->phase = 0;
+	inDecimator->history[0] = 0;
+	inDecimator->history[1] = 0;
+	return buff_err_success;
+}
+
+bool decimator_push(decimator_t* inDecimator, uint16_t inCode, uint16_t* outSample)
+{
+	// integrators at the input rate, wrapping freely
+	uint32_t value = inCode;
+	for(uint32_t stage = 0; stage < DECIMATOR_CIC_ORDER; stage++)
+	{
+		inDecimator->integrators[stage] += value;
+		value = inDecimator->integrators[stage];
+	}
+
+	if(++inDecimator->phase < inDecimator->ratio)
+	{
+		return false;
+	}
+	inDecimator->phase = 0;
+
+	// combs at the output rate, where the wraparound cancels
+	for(uint32_t stage = 0; stage < DECIMATOR_CIC_ORDER; stage++)
+	{
+		uint32_t previous = inDecimator->combs[stage];
+		inDecimator->combs[stage] = value;
+		value -= previous;
+	}
+
+	/**
+	 * value is up to 4095 ratio^order. Dividing out the gain is one 64 bit
+	 * division per output, at the report rate, so the cost does not matter.
+	 */
+	int32_t scaled = (int32_t)((((uint64_t)value << DECIMATOR_FRACTION_BITS) + inDecimator->gain / 2)
+			                   / inDecimator->gain);
+
+	// the newest output is the right-hand tap, so the centre is one output ago
+	// a full scale centre tap is just over 2^31, so this is summed in 64 bits
+	int64_t acc = (int64_t)DECIMATOR_COMP_OUTER * (inDecimator->history[1] + scaled)
+			    + (int64_t)DECIMATOR_COMP_CENTRE * inDecimator->history[0];
+	inDecimator->history[1] = inDecimator->history[0];
+	inDecimator->history[0] = scaled;
+
+	int64_t out = (acc + (1 << 14)) >> 15;
+	*outSample = out < 0 ? 0 : (out > UINT16_MAX ? UINT16_MAX : (uint16_t)out);
+	return true;
+}
@@ -0,0 +1,56 @@
+/*
+ * @file dsp_stats.c
+ * @brief Project 6
+ *
+ * @details Block statistics on the DSP buffer through the CMSIS-DSP
+ *          statistics kernels.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "dsp_stats.h"
+#include "isqrt.h"
+
+/**
+ * Undo the headroom scaling, rounding to nearest.
+ */
+static q15_t unscale(q15_t inValue, uint32_t inHeadroomBits)
+{
+	if(!inHeadroomBits)
+	{
+		return inValue;
+	}
+	return (q15_t)(((q31_t)inValue + (1 << (inHeadroomBits - 1))) >> inHeadroomBits);
+}
+
+void dsp_block_stats_q15(q15_t* inOutBlock, uint32_t inCount, uint32_t inHeadroomBits,
+		                 dsp_block_stats_t* outStats)
+{
+	if(inHeadroomBits)
+	{
+		arm_shift_q15(inOutBlock, (int8_t)inHeadroomBits, inOutBlock, inCount);
+	}
+
+	arm_min_q15(inOutBlock, inCount, &outStats->min, &outStats->minIndex);
+	arm_max_q15(inOutBlock, inCount, &outStats->max, &outStats->maxIndex);
+	arm_mean_q15(inOutBlock, inCount, &outStats->mean);
+	arm_std_q15(inOutBlock, inCount, &outStats->stdDev);
+	arm_rms_q15(inOutBlock, inCount, &outStats->rms);
+
+	// sample to population standard deviation: times sqrt((n - 1) / n)
+	uint64_t sampleSquared = (uint64_t)((int32_t)outStats->stdDev * outStats->stdDev);
+	outStats->stdDev = inCount > 1 ?
+		(q15_t)isqrt64((sampleSquared * (inCount - 1) + inCount / 2) / inCount) : 0;
+
+	outStats->min = unscale(outStats->min, inHeadroomBits);
+	outStats->max = unscale(outStats->max, inHeadroomBits);
+	outStats->mean = unscale(outStats->mean, inHeadroomBits);
+	outStats->stdDev = unscale(outStats->stdDev, inHeadroomBits);
+	outStats->rms = unscale(outStats->rms, inHeadroomBits);
+}
@@ -0,0 +1,264 @@
+/*
+ * @file fft.c
+ * @brief Project 6
+ *
+ * @details Fixed-point radix-2 FFT and the block spectrum report.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "fft.h"
+#include "isqrt.h"
+#include "const_trig.h"
+
+/**
+ * Compile-time tables, folded by the compiler from const_trig.h.
+ */
+#define FFT_ANGLE(k) CONST_TRIG_ANGLE(k, FFT_SIZE)
+
+#define FFT_TWIDDLE_COS(k) CONST_TRIG_Q15(CONST_TRIG_COS_HALF(FFT_ANGLE(k))),
+#define FFT_TWIDDLE_SIN(k) CONST_TRIG_Q15(CONST_TRIG_SIN_HALF(FFT_ANGLE(k))),
+
+// periodic Hann window, 0.5 - 0.5 cos, mirrored about FFT_SIZE / 2
+#define FFT_HANN(n) CONST_TRIG_Q15(0.5 - 0.5 * CONST_TRIG_COS_HALF(FFT_ANGLE( \
+                    ((n) <= FFT_SIZE / 2) ? (n) : FFT_SIZE - (n)))),
+
+#if FFT_LOG2_SIZE == 2
+#define FFT_REPEAT_HALF(m) CONST_TRIG_REPEAT_2(m, 0)
+#define FFT_REPEAT_FULL(m) CONST_TRIG_REPEAT_4(m, 0)
+#elif FFT_LOG2_SIZE == 3
+#define FFT_REPEAT_HALF(m) CONST_TRIG_REPEAT_4(m, 0)
+#define FFT_REPEAT_FULL(m) CONST_TRIG_REPEAT_8(m, 0)
+#elif FFT_LOG2_SIZE == 4
+#define FFT_REPEAT_HALF(m) CONST_TRIG_REPEAT_8(m, 0)
+#define FFT_REPEAT_FULL(m) CONST_TRIG_REPEAT_16(m, 0)
+#elif FFT_LOG2_SIZE == 5
+#define FFT_REPEAT_HALF(m) CONST_TRIG_REPEAT_16(m, 0)
+#define FFT_REPEAT_FULL(m) CONST_TRIG_REPEAT_32(m, 0)
+#elif FFT_LOG2_SIZE == 6
+#define FFT_REPEAT_HALF(m) CONST_TRIG_REPEAT_32(m, 0)
+#define FFT_REPEAT_FULL(m) CONST_TRIG_REPEAT_64(m, 0)
+#elif FFT_LOG2_SIZE == 7
+#define FFT_REPEAT_HALF(m) CONST_TRIG_REPEAT_64(m, 0)
+#define FFT_REPEAT_FULL(m) CONST_TRIG_REPEAT_128(m, 0)
+#elif FFT_LOG2_SIZE == 8
+#define FFT_REPEAT_HALF(m) CONST_TRIG_REPEAT_128(m, 0)
+#define FFT_REPEAT_FULL(m) CONST_TRIG_REPEAT_256(m, 0)
+#elif FFT_LOG2_SIZE == 9
+#define FFT_REPEAT_HALF(m) CONST_TRIG_REPEAT_256(m, 0)
+#define FFT_REPEAT_FULL(m) CONST_TRIG_REPEAT_512(m, 0)
+#else
+#define FFT_REPEAT_HALF(m) CONST_TRIG_REPEAT_512(m, 0)
+#define FFT_REPEAT_FULL(m) CONST_TRIG_REPEAT_1024(m, 0)
+#endif
+
+/**
+ * Twiddle factors W^k = cos(2 pi k / N) - j sin(2 pi k / N), k < N / 2.
+ */
+static const q15_t sTwiddleCos[FFT_SIZE / 2] = { FFT_REPEAT_HALF(FFT_TWIDDLE_COS) };
+static const q15_t sTwiddleSin[FFT_SIZE / 2] = { FFT_REPEAT_HALF(FFT_TWIDDLE_SIN) };
+
+/**
+ * Window applied before the transform, so a tone between bins stays within
+ * a few bins instead of leaking across the whole spectrum.
+ */
+static const q15_t sHannWindow[FFT_SIZE] = { FFT_REPEAT_FULL(FFT_HANN) };
+
+/**
+ * Reverse the low FFT_LOG2_SIZE bits of an index.
+ */
+static uint32_t bit_reverse(uint32_t inIndex)
+{
+	uint32_t reversed = 0;
+	for(uint32_t bit = 0; bit < FFT_LOG2_SIZE; bit++)
+	{
+		reversed = (reversed << 1) | (inIndex & 1u);
+		inIndex >>= 1;
+	}
+	return reversed;
+}
+
+void fft_q15(q15_t* inOutData)
+{
+	// decimation in time works on bit-reversed input
+	for(uint32_t i = 0; i < FFT_SIZE; i++)
+	{
+		uint32_t j = bit_reverse(i);
+		if(j > i)
+		{
+			q15_t re = inOutData[2 * i];
+			q15_t im = inOutData[2 * i + 1];
+			inOutData[2 * i] = inOutData[2 * j];
+			inOutData[2 * i + 1] = inOutData[2 * j + 1];
+			inOutData[2 * j] = re;
+			inOutData[2 * j + 1] = im;
+		}
+	}
+
+	// each stage merges pairs of half-length transforms and halves the result
+	for(uint32_t half = 1, step = FFT_SIZE / 2; half < FFT_SIZE; half <<= 1, step >>= 1)
+	{
+		for(uint32_t start = 0; start < FFT_SIZE; start += 2 * half)
+		{
+			for(uint32_t j = 0; j < half; j++)
+			{
+				int32_t c = sTwiddleCos[j * step];
+				int32_t s = sTwiddleSin[j * step];
+				q15_t* a = &inOutData[2 * (start + j)];
+				q15_t* b = &inOutData[2 * (start + j + half)];
+
+				// b * W, with |b * W| <= |b| so neither sum overflows
+				int32_t tRe = (b[0] * c + b[1] * s) >> 15;
+				int32_t tIm = (b[1] * c - b[0] * s) >> 15;
+
+				int32_t aRe = a[0];
+				int32_t aIm = a[1];
+				a[0] = (q15_t)((aRe + tRe) >> 1);
+				a[1] = (q15_t)((aIm + tIm) >> 1);
+				b[0] = (q15_t)((aRe - tRe) >> 1);
+				b[1] = (q15_t)((aIm - tIm) >> 1);
+			}
+		}
+	}
+}
+
+/**
+ * Power of bin inBin, |X|^2. At most 2^30 for a transform within 1.0.
+ */
+static uint32_t bin_power(const q15_t* inSpectrum, uint32_t inBin)
+{
+	int32_t re = inSpectrum[2 * inBin];
+	int32_t im = inSpectrum[2 * inBin + 1];
+	return (uint32_t)(re * re) + (uint32_t)(im * im);
+}
+
+/**
+ * Power summed over the main lobe around inCenter, kept within 1 to N / 2.
+ */
+static uint64_t lobe_power(const q15_t* inSpectrum, uint32_t inCenter)
+{
+	uint32_t first = inCenter > FFT_LOBE_BINS ? inCenter - FFT_LOBE_BINS : 1u;
+	uint32_t last = inCenter + FFT_LOBE_BINS;
+	last = last < FFT_SIZE / 2 ? last : FFT_SIZE / 2;
+
+	uint64_t power = 0;
+	for(uint32_t bin = first; bin <= last; bin++)
+	{
+		power += bin_power(inSpectrum, bin);
+	}
+	return power;
+}
+
+buff_err fft_analyze_block_u16(const uint16_t* inBlock, uint32_t inCount,
+		                       uint32_t inSampleRateMilliHz, q15_t* inWork,
+		                       fft_analysis_t* outAnalysis)
+{
+	if(!inBlock || !inWork || !outAnalysis || inCount != FFT_SIZE)
+	{
+		return buff_err_invalid;
+	}
+
+	/**
+	 * Remove the mean so the window does not smear DC over the low bins,
+	 * then scale the codes to use the top of 1.15, as dsp_stats does.
+	 * With the mean removed each code is within +-4095, so 3 bits fit.
+	 */
+	uint32_t sum = 0;
+	for(uint32_t i = 0; i < FFT_SIZE; i++)
+	{
+		sum += inBlock[i];
+	}
+	int32_t mean = (int32_t)((sum + FFT_SIZE / 2) >> FFT_LOG2_SIZE);
+	outAnalysis->dcOffset = (uint32_t)mean;
+
+	for(uint32_t i = 0; i < FFT_SIZE; i++)
+	{
+		int32_t centered = ((int32_t)inBlock[i] - mean) * (1 << DSP_STATS_ADC_HEADROOM);
+		inWork[2 * i] = (q15_t)((centered * sHannWindow[i]) >> 15);
+		inWork[2 * i + 1] = 0;
+	}
+
+	fft_q15(inWork);
+
+	// the strongest bin above DC is taken as the fundamental
+	uint32_t peak = 0;
+	uint32_t peakPower = 0;
+	for(uint32_t bin = 1; bin <= FFT_SIZE / 2; bin++)
+	{
+		uint32_t power = bin_power(inWork, bin);
+		if(power > peakPower)
+		{
+			peakPower = power;
+			peak = bin;
+		}
+	}
+
+	outAnalysis->peakBin = peak;
+	outAnalysis->fundamentalMilliHz = 0;
+	outAnalysis->amplitude = 0;
+	outAnalysis->thdPpm = 0;
+	if(!peak)
+	{
+		return buff_err_success;
+	}
+	// nearer DC the lobe takes in the tone's image and its second harmonic
+	if(peak <= 2 * FFT_LOBE_BINS)
+	{
+		return buff_err_invalid;
+	}
+
+	/**
+	 * Offset of the tone from the peak bin, in 1/256 bin, from the
+	 * magnitudes either side. For a Hann window the offset is
+	 * 2 (right - left) / (left + 2 peak + right).
+	 */
+	int32_t left = (int32_t)isqrt32(bin_power(inWork, peak - 1));
+	int32_t centre = (int32_t)isqrt32(peakPower);
+	int32_t right = peak < FFT_SIZE / 2 ? (int32_t)isqrt32(bin_power(inWork, peak + 1)) : left;
+	int32_t offsetQ8 = (2 * 256 * (right - left)) / (left + 2 * centre + right);
+	uint32_t toneQ8 = (uint32_t)((int32_t)(peak << 8) + offsetQ8);
+
+	outAnalysis->fundamentalMilliHz = (uint32_t)(((uint64_t)toneQ8 * inSampleRateMilliHz)
+			                                      >> (FFT_LOG2_SIZE + 8));
+
+	/**
+	 * A windowed tone of amplitude A carries 3 A^2 / 32 in the positive
+	 * half of the spectrum (Parseval, with sum(w^2) = 3N / 8). The samples
+	 * were scaled by 8, so in ADC codes A = sqrt(power / 6).
+	 */
+	uint64_t fundamental = lobe_power(inWork, peak);
+	outAnalysis->amplitude = (isqrt64((fundamental << 8) / 6u) + 8u) >> 4;
+
+	// each harmonic is summed around the nearest bin to h times the tone
+	uint64_t harmonics = 0;
+	for(uint32_t h = 2; h <= FFT_THD_MAX_HARMONIC; h++)
+	{
+		uint32_t center = (h * toneQ8 + 128u) >> 8;
+		if(center > FFT_SIZE / 2)
+		{
+			break;
+		}
+		harmonics += lobe_power(inWork, center);
+	}
+
+	/**
+	 * THD = sqrt(harmonics / fundamental). The ratio is taken with as many
+	 * fractional bits as the harmonic power leaves room for, an even number
+	 * so the root has half as many.
+	 */
+	uint32_t fracBits = 0;
+	while(fracBits < 40u && (harmonics >> (60u - fracBits)) == 0)
+	{
+		fracBits += 2;
+	}
+	uint64_t ratio = (harmonics << fracBits) / fundamental;
+	outAnalysis->thdPpm = (uint32_t)(((uint64_t)isqrt64(ratio) * 1000000u) >> (fracBits / 2));
+
+	return buff_err_success;
+}
@@ -0,0 +1,237 @@
+/*
+ * @file filter_chain.c
+ * @brief Project 6
+ *
+ * @details Fixed-point filters on each ADC block, and their cycle counts.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include <stdbool.h>
+#include "filter_chain.h"
+
+#if FILTER_CHAIN_STAGES
+
+#include "dc_blocker.h"
+#include "adc_stats.h"
+#include "cycle_count.h"
+#include "logger.h"
+
+/**
+ * Largest code the chain hands back.
+ */
+#define FILTER_CHAIN_MAX_CODE ((1 << ADC_RESOLUTION_BITS) - 1)
+
+/**
+ * One stage: how to start it at a level, how to run it, and the cycles and
+ * samples it has run for.
+ */
+typedef struct filter_stage_t {
+	const char* name;
+	void (*prime)(q15_t inLevel);
+	void (*process)(q15_t* ioBlock, uint32_t inCount);
+	uint32_t cycles;
+	uint32_t samples;
+} filter_stage_t;
+
+#if FILTER_CHAIN_DC_BLOCK
+static dc_blocker_t sDcBlocker;
+
+static void dc_block_prime(q15_t inLevel)
+{
+	dc_blocker_prime(&sDcBlocker, inLevel);
+}
+
+static void dc_block_stage(q15_t* ioBlock, uint32_t inCount)
+{
+	dc_blocker_q15(&sDcBlocker, ioBlock, inCount);
+}
+#endif
+
+#if FILTER_CHAIN_BIQUAD_Q15
+/**
+ * Butterworth lowpass at fs / 10: b = {0.0675, 0.1349, 0.0675},
+ * -a = {1.1430, -0.4128}. Halved to fit 1.15, so postShift is 1.
+ * The numerator sums to exactly the denominator, for unity gain at DC.
+ */
+static q15_t sBiquadQ15Coeffs[6] = { 1105, 0, 2210, 1105, 18727, -6763 };
+static q15_t sBiquadQ15State[4];
+static arm_biquad_casd_df1_inst_q15 sBiquadQ15;
+
+/**
+ * Unity gain at DC, so the steady state has every input and output at the level.
+ */
+static void biquad_q15_prime(q15_t inLevel)
+{
+	for(uint32_t i = 0; i < 4; i++)
+	{
+		sBiquadQ15State[i] = inLevel;
+	}
+}
+
+static void biquad_q15_stage(q15_t* ioBlock, uint32_t inCount)
+{
+	arm_biquad_cascade_df1_q15(&sBiquadQ15, ioBlock, ioBlock, inCount);
+}
+#endif
+
+#if FILTER_CHAIN_BIQUAD_Q31
+/**
+ * Butterworth lowpass at fs / 20: b = {0.0201, 0.0402, 0.0201},
+ * -a = {1.5610, -0.6414}, halved to fit 1.31, so postShift is 1.
+ */
+static q31_t sBiquadQ31Coeffs[5] = { 21564350, 43128699, 21564350, 1676130396, -688645970 };
+static q31_t sBiquadQ31State[4];
+static arm_biquad_casd_df1_inst_q31 sBiquadQ31;
+
+/**
+ * The block widened to 1.31 for the filter.
+ */
+static q31_t sBiquadQ31Work[FILTER_CHAIN_MAX_BLOCK];
+
+static void biquad_q31_prime(q15_t inLevel)
+{
+	for(uint32_t i = 0; i < 4; i++)
+	{
+		sBiquadQ31State[i] = (q31_t)inLevel << 16;
+	}
+}
+
+static void biquad_q31_stage(q15_t* ioBlock, uint32_t inCount)
+{
+	arm_q15_to_q31(ioBlock, sBiquadQ31Work, inCount);
+	arm_biquad_cascade_df1_q31(&sBiquadQ31, sBiquadQ31Work, sBiquadQ31Work, inCount);
+	arm_q31_to_q15(sBiquadQ31Work, ioBlock, inCount);
+}
+#endif
+
+#if FILTER_CHAIN_FIR
+/**
+ * Taps of a Hamming windowed sinc at fs / 8, symmetric, so the time
+ * reversed order the kernel wants is the same. They sum to 1.0 exactly.
+ */
+#define FILTER_CHAIN_FIR_TAPS 8
+static q15_t sFirCoeffs[FILTER_CHAIN_FIR_TAPS] = { 117, 1248, 5277, 9742, 9742, 5277, 1248, 117 };
+static q15_t sFirState[FILTER_CHAIN_FIR_TAPS + FILTER_CHAIN_MAX_BLOCK - 1];
+static arm_fir_instance_q15 sFir;
+
+/**
+ * The previous numTaps - 1 inputs lead the state.
+ */
+static void fir_prime(q15_t inLevel)
+{
+	for(uint32_t i = 0; i < FILTER_CHAIN_FIR_TAPS - 1; i++)
+	{
+		sFirState[i] = inLevel;
+	}
+}
+
+static void fir_stage(q15_t* ioBlock, uint32_t inCount)
+{
+	arm_fir_q15(&sFir, ioBlock, ioBlock, inCount);
+}
+#endif
+
+/**
+ * The stages that are built, in the order they run.
+ */
+static filter_stage_t sStages[FILTER_CHAIN_STAGES] = {
+#if FILTER_CHAIN_DC_BLOCK
+	{ "DC blocker", dc_block_prime, dc_block_stage, 0, 0 },
+#endif
+#if FILTER_CHAIN_BIQUAD_Q15
+	{ "Q15 biquad", biquad_q15_prime, biquad_q15_stage, 0, 0 },
+#endif
+#if FILTER_CHAIN_BIQUAD_Q31
+	{ "Q31 biquad", biquad_q31_prime, biquad_q31_stage, 0, 0 },
+#endif
+#if FILTER_CHAIN_FIR
+	{ "Q15 FIR", fir_prime, fir_stage, 0, 0 },
+#endif
+};
+
+/**
+ * Whether the stages have been started at the level of the first block.
+ */
+static bool sPrimed;
+
+void filter_chain_init()
+{
+#if FILTER_CHAIN_DC_BLOCK
+	dc_blocker_init(&sDcBlocker, 32440, 1 << (ADC_RESOLUTION_BITS - 1));
+#endif
+#if FILTER_CHAIN_BIQUAD_Q15
+	arm_biquad_cascade_df1_init_q15(&sBiquadQ15, 1, sBiquadQ15Coeffs, sBiquadQ15State, 1);
+#endif
+#if FILTER_CHAIN_BIQUAD_Q31
+	arm_biquad_cascade_df1_init_q31(&sBiquadQ31, 1, sBiquadQ31Coeffs, sBiquadQ31State, 1);
+#endif
+#if FILTER_CHAIN_FIR
+	arm_fir_init_q15(&sFir, FILTER_CHAIN_FIR_TAPS, sFirCoeffs, sFirState, FILTER_CHAIN_MAX_BLOCK);
+#endif
+	for(uint32_t i = 0; i < FILTER_CHAIN_STAGES; i++)
+	{
+		sStages[i].cycles = 0;
+		sStages[i].samples = 0;
+	}
+	sPrimed = false;
+}
+
+uint32_t filter_chain_process(q15_t* ioBlock, uint32_t inCount)
+{
+	if(inCount > FILTER_CHAIN_MAX_BLOCK)
+	{
+		inCount = FILTER_CHAIN_MAX_BLOCK;
+	}
+
+	if(!inCount)
+	{
+		return 0;
+	}
+
+	uint32_t total = 0;
+	for(uint32_t i = 0; i < FILTER_CHAIN_STAGES; i++)
+	{
+		uint32_t start = cycle_count_now();
+		if(!sPrimed)
+		{
+			// what reaches this stage first, so zero state does not ramp up from 0 V
+			sStages[i].prime(ioBlock[0]);
+		}
+		sStages[i].process(ioBlock, inCount);
+		uint32_t cycles = cycle_count_now() - start;
+		sStages[i].cycles += cycles;
+		sStages[i].samples += inCount;
+		total += cycles;
+	}
+	sPrimed = true;
+
+	// overshoot and the DC blocker's offset must not leave the range of a code
+	for(uint32_t n = 0; n < inCount; n++)
+	{
+		ioBlock[n] = ioBlock[n] < 0 ? 0 : (ioBlock[n] > FILTER_CHAIN_MAX_CODE ? FILTER_CHAIN_MAX_CODE : ioBlock[n]);
+	}
+	return total;
+}
+
+void filter_chain_log()
+{
+	for(uint32_t i = 0; i < FILTER_CHAIN_STAGES; i++)
+	{
+		uint32_t samples = sStages[i].samples ? sStages[i].samples : 1u;
+		uint32_t centiCycles = (uint32_t)(((uint64_t)sStages[i].cycles * 100u) / samples);
+		LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "%s: %u.%02u cycles per sample over %u samples",
+				sStages[i].name,
+				centiCycles / 100u,
+				centiCycles % 100u,
+				sStages[i].samples);
+	}
+}
+
+#endif
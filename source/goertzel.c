@@ -0,0 +1,138 @@
+/*
+ * @file goertzel.c
+ * @brief Project 6
+ *
+ * @details Goertzel single-tone detector.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "goertzel.h"
+#include "isqrt.h"
+
+/**
+ * Fractional bits given to the samples, so rounding in the recursion stays
+ * well below one ADC code.
+ */
+#define GOERTZEL_FRACTION_BITS 4
+
+/**
+ * inState * inCoeff / 2^30 for a 2.30 coefficient, rounded down.
+ *
+ * Both are split into 16 bit halves so every partial product fits in 32
+ * bits, which keeps the per-sample loop to the M0+'s single cycle multiply
+ * instead of a 64 bit library call. The cross terms are summed a quarter
+ * scale so they cannot overflow. For |inState| < 2^30 the result is within
+ * 1 of exact.
+ */
+static inline int32_t mul_q30(int32_t inState, int32_t inCoeff)
+{
+	int32_t stateHigh = inState >> 16;
+	int32_t stateLow = inState & 0xFFFF;
+	int32_t coeffHigh = inCoeff >> 16;
+	int32_t coeffLow = inCoeff & 0xFFFF;
+	int32_t cross = ((stateHigh * coeffLow) >> 2) + ((stateLow * coeffHigh) >> 2)
+			+ (int32_t)(((uint32_t)stateLow * (uint32_t)coeffLow) >> 18);
+	return stateHigh * coeffHigh * 4 + (cross >> 12);
+}
+
+buff_err goertzel_block_u16(const uint16_t* inBlock, uint32_t inCount, int32_t inOffset,
+		                    const goertzel_target_t* inTargets, uint32_t inTargetCount,
+		                    goertzel_result_t* outResults)
+{
+	if(!inBlock || !inTargets || !outResults)
+	{
+		return buff_err_invalid;
+	}
+
+	for(uint32_t t = 0; t < inTargetCount; t++)
+	{
+		const goertzel_target_t* target = &inTargets[t];
+		if(!target->length || target->length > inCount)
+		{
+			return buff_err_invalid;
+		}
+
+		// s[n] = x[n] + 2 cos(w) s[n - 1] - s[n - 2]
+		int32_t coeff = target->coeff;
+		int32_t s1 = 0;
+		int32_t s2 = 0;
+		for(uint32_t n = 0; n < target->length; n++)
+		{
+			int32_t x = ((int32_t)inBlock[n] - inOffset) * (1 << GOERTZEL_FRACTION_BITS);
+			int32_t s0 = x + mul_q30(s1, coeff) - s2;
+			s2 = s1;
+			s1 = s0;
+		}
+
+		/**
+		 * The last output, s1 - e^-jw s2, is the DFT at w referred to the
+		 * last sample. It is a small difference of large states, so it is
+		 * taken in 2.30 before dropping to 1.15 and turning it back by
+		 * w (length - 1), which refers it to the first sample, in 2.30.
+		 */
+		int64_t yRe = (((int64_t)s1 << 30) - (int64_t)s2 * target->cosW) >> 15;
+		int64_t yIm = ((int64_t)s2 * target->sinW) >> 15;
+		int64_t re = yRe * target->cosEnd + yIm * target->sinEnd;
+		int64_t im = yIm * target->cosEnd - yRe * target->sinEnd;
+
+		// a tone of amplitude A reads A length / 2, so A = 2 |X| / length
+		int64_t reQ1 = re >> (29 + GOERTZEL_FRACTION_BITS);
+		int64_t imQ1 = im >> (29 + GOERTZEL_FRACTION_BITS);
+		uint32_t magnitudeQ1 = isqrt64((uint64_t)(reQ1 * reQ1) + (uint64_t)(imQ1 * imQ1));
+		outResults[t].amplitude = (magnitudeQ1 + target->length / 2) / target->length;
+		outResults[t].phaseCentiDeg = goertzel_atan2_centideg(im, re);
+	}
+
+	return buff_err_success;
+}
+
+int32_t goertzel_atan2_centideg(int64_t inY, int64_t inX)
+{
+	uint64_t x = inX < 0 ? (uint64_t)-inX : (uint64_t)inX;
+	uint64_t y = inY < 0 ? (uint64_t)-inY : (uint64_t)inY;
+	if(!x && !y)
+	{
+		return 0;
+	}
+
+	// the smaller over the larger, in 1.15, with the larger brought under 2^32
+	uint64_t small = x < y ? x : y;
+	uint64_t large = x < y ? y : x;
+	while(large >> 32)
+	{
+		small >>= 1;
+		large >>= 1;
+	}
+	int32_t z = (int32_t)((small << 15) / large);
+
+	/**
+	 * atan(z) on [0, 1] as an odd polynomial to z^9, within 1e-5 rad
+	 * (Abramowitz and Stegun 4.4.49). Coefficients are in hundredths of a
+	 * degree with 2 extra fractional bits, evaluated in z^2 by Horner.
+	 */
+	int32_t zSquared = (z * z) >> 15;
+	int32_t poly = 478;
+	poly = -1951 + ((poly * zSquared) >> 15);
+	poly = 4129 + ((poly * zSquared) >> 15);
+	poly = -7570 + ((poly * zSquared) >> 15);
+	poly = 22915 + ((poly * zSquared) >> 15);
+	int32_t angle = (((poly * z) >> 15) + 2) >> 2;
+
+	// back out to the octant (inX, inY) is in
+	if(y > x)
+	{
+		angle = 9000 - angle;
+	}
+	if(inX < 0)
+	{
+		angle = 18000 - angle;
+	}
+	return inY < 0 ? -angle : angle;
+}
@@ -0,0 +1,143 @@
+/*
+ * @file histogram.c
+ * @brief Project 6
+ *
+ * @details Compact histogram of ADC codes with percentile queries.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "histogram.h"
+
+void histogram_reset(histogram_t* outHistogram)
+{
+	for(uint32_t i = 0; i < HISTOGRAM_BINS; i++)
+	{
+		outHistogram->bins[i] = 0;
+	}
+	outHistogram->total = 0;
+	outHistogram->halvings = 0;
+	outHistogram->dither = 1;
+}
+
+/**
+ * A count at 2^-inShift of its weight. The fraction is rounded up with that
+ * probability, so counts stay unbiased however small the pieces: a block of
+ * 64 samples folded into a lifetime histogram halved 4 times adds 4 counts
+ * on average, where rounding up would add one per occupied bin and rounding
+ * to nearest none at all. LCG constants from Numerical Recipes.
+ */
+static inline uint32_t scale_down(histogram_t* inHistogram, uint32_t inCount, uint32_t inShift)
+{
+	if(!inShift)
+	{
+		return inCount;
+	}
+	if(inShift >= 32)
+	{
+		return 0;
+	}
+	inHistogram->dither = inHistogram->dither * 1664525u + 1013904223u;
+	uint32_t fraction = inCount & ((1u << inShift) - 1);
+	return (inCount >> inShift) + ((inHistogram->dither >> (32 - inShift)) < fraction);
+}
+
+/**
+ * Halve every bin, so each count stands for twice as many samples.
+ */
+static void halve(histogram_t* inHistogram)
+{
+	uint32_t total = 0;
+	for(uint32_t i = 0; i < HISTOGRAM_BINS; i++)
+	{
+		inHistogram->bins[i] = (uint16_t)scale_down(inHistogram, inHistogram->bins[i], 1);
+		total += inHistogram->bins[i];
+	}
+	inHistogram->total = total;
+	inHistogram->halvings++;
+}
+
+void histogram_add_block_u16(histogram_t* inHistogram, const uint16_t* inSamples, uint32_t inCount)
+{
+	for(uint32_t i = 0; i < inCount; i++)
+	{
+		uint32_t bin = (uint32_t)inSamples[i] >> HISTOGRAM_BIN_SHIFT;
+		if(bin >= HISTOGRAM_BINS)
+		{
+			bin = HISTOGRAM_BINS - 1;
+		}
+		// once halved, a sample is less than a count
+		if(inHistogram->halvings && !scale_down(inHistogram, 1, inHistogram->halvings))
+		{
+			continue;
+		}
+		if(inHistogram->bins[bin] == HISTOGRAM_MAX_COUNT)
+		{
+			halve(inHistogram);
+		}
+		inHistogram->bins[bin]++;
+		inHistogram->total++;
+	}
+}
+
+void histogram_merge(histogram_t* inOutTotal, const histogram_t* inHistogram)
+{
+	while(inOutTotal->halvings < inHistogram->halvings)
+	{
+		halve(inOutTotal);
+	}
+
+	uint32_t shift = inOutTotal->halvings - inHistogram->halvings;
+	for(uint32_t i = 0; i < HISTOGRAM_BINS; i++)
+	{
+		uint32_t count = scale_down(inOutTotal, inHistogram->bins[i], shift);
+		// halve until the sum fits, folding the halving into the count added
+		while(inOutTotal->bins[i] + count > HISTOGRAM_MAX_COUNT)
+		{
+			halve(inOutTotal);
+			count = scale_down(inOutTotal, count, 1);
+			shift++;
+		}
+		inOutTotal->bins[i] = (uint16_t)(inOutTotal->bins[i] + count);
+		inOutTotal->total += count;
+	}
+}
+
+buff_err histogram_percentile(const histogram_t* inHistogram, uint32_t inCentiPercent, uint16_t* outCode)
+{
+	if(!inHistogram->total)
+	{
+		return buff_err_empty;
+	}
+	if(inCentiPercent > 10000)
+	{
+		return buff_err_invalid;
+	}
+
+	// nearest rank, counting from 1
+	uint32_t rank = (uint32_t)(((uint64_t)inHistogram->total * inCentiPercent + 9999) / 10000);
+	if(!rank)
+	{
+		rank = 1;
+	}
+
+	uint32_t below = 0;
+	uint32_t bin = 0;
+	while(below + inHistogram->bins[bin] < rank)
+	{
+		below += inHistogram->bins[bin];
+		bin++;
+	}
+
+	// the count's samples spread evenly over the bin, each at the middle of its share
+	uint32_t count = inHistogram->bins[bin];
+	uint32_t offset = ((2 * (rank - below) - 1) * HISTOGRAM_BIN_WIDTH) / (2 * count);
+	*outCode = (uint16_t)((bin << HISTOGRAM_BIN_SHIFT) + offset);
+	return buff_err_success;
+}
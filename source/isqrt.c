@@ -0,0 +1,76 @@
+/*
+ * @file isqrt.c
+ * @brief Project 6
+ *
+ * @details Integer square roots.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ *
+ *  LEVERAGED ALGORITHM: digit-by-digit (binary) square root
+ *  https://en.wikipedia.org/wiki/Methods_of_computing_square_roots#Binary_numeral_system_(base_2)
+ */
+
+#include "isqrt.h"
+
+uint32_t isqrt32(uint32_t inValue)
+{
+	uint32_t result = 0;
+	uint32_t bit = 1u << 30;
+
+	// start at the highest power of four not above the value
+	while(bit > inValue)
+	{
+		bit >>= 2;
+	}
+
+	while(bit)
+	{
+		if(inValue >= result + bit)
+		{
+			inValue -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return result;
+}
+
+uint32_t isqrt64(uint64_t inValue)
+{
+	if(inValue <= UINT32_MAX)
+	{
+		return isqrt32((uint32_t)inValue);
+	}
+
+	uint64_t result = 0;
+	uint64_t bit = 1ull << 62;
+	while(bit > inValue)
+	{
+		bit >>= 2;
+	}
+
+	while(bit)
+	{
+		if(inValue >= result + bit)
+		{
+			inValue -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint32_t)result;
+}
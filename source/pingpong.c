@@ -0,0 +1,78 @@
+/*
+ * @file pingpong.c
+ * @brief Project 6
+ *
+ * @details A ping-pong (double) block buffer.
+ *
+ *          ready is the only shared word. The producer only stores to it while
+ *          it is PINGPONG_NONE and the consumer only stores to it while it is
+ *          not, so a plain word store with release ordering is enough on the
+ *          Cortex-M0+.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "pingpong.h"
+#include "spsc_ring.h"
+
+buff_err pingpong_init(pingpong_t* outBuf, uint16_t* inStorage, size_t inBlockSize)
+{
+	if(!outBuf || !inStorage || !inBlockSize)
+	{
+		return buff_err_invalid;
+	}
+
+	outBuf->blocks[0] = inStorage;
+	outBuf->blocks[1] = inStorage + inBlockSize;
+	outBuf->blockSize = inBlockSize;
+	outBuf->fill = 0;
+	outBuf->fillIndex = 0;
+	outBuf->ready = PINGPONG_NONE;
+	outBuf->overruns = 0;
+	return buff_err_success;
+}
+
+bool pingpong_push(pingpong_t* inBuf, uint16_t inSample)
+{
+	inBuf->blocks[inBuf->fillIndex][inBuf->fill++] = inSample;
+	if(inBuf->fill < inBuf->blockSize)
+	{
+		return false;
+	}
+
+	inBuf->fill = 0;
+	if(SPSC_LOAD_ACQUIRE(&inBuf->ready) != PINGPONG_NONE)
+	{
+		// the consumer still owns the other block, refill this one
+		inBuf->overruns++;
+		return false;
+	}
+
+	SPSC_STORE_RELEASE(&inBuf->ready, inBuf->fillIndex);
+	inBuf->fillIndex ^= 1;
+	return true;
+}
+
+uint16_t* pingpong_acquire(pingpong_t* inBuf, size_t* outCount)
+{
+	uint32_t ready = SPSC_LOAD_ACQUIRE(&inBuf->ready);
+	if(ready == PINGPONG_NONE)
+	{
+		*outCount = 0;
+		return NULL;
+	}
+
+	*outCount = inBuf->blockSize;
+	return inBuf->blocks[ready];
+}
+
+void pingpong_release(pingpong_t* inBuf)
+{
+	SPSC_STORE_RELEASE(&inBuf->ready, PINGPONG_NONE);
+}
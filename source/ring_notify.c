@@ -0,0 +1,20 @@
+/*
+ * @file ring_notify.c
+ * @brief Project 6
+ *
+ * @details Instantiations of the notifying ring buffers.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "ring_notify.h"
+
+RING_NOTIFY_DEFINE(ring_notify_u8, spsc_ring_u8, uint8_t)
+
+RING_NOTIFY_DEFINE(ring_notify, spsc_ring, uint32_t)
@@ -0,0 +1,79 @@
+/*
+ * @file ring_stats.c
+ * @brief Project 6
+ *
+ * @details Optional occupancy and drop counters for the ring buffers.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "ring_stats.h"
+#include "logger.h"
+#include <stddef.h>
+
+/**
+ * @brief Head of the list of registered counters
+ */
+static ring_stats_t* sStatsHead = NULL;
+
+void ring_stats_register(ring_stats_t* inStats, const char* inName)
+{
+	ring_stats_unregister(inStats);
+	inStats->name = inName;
+	inStats->next = sStatsHead;
+	sStatsHead = inStats;
+}
+
+void ring_stats_unregister(ring_stats_t* inStats)
+{
+	ring_stats_t** iter = &sStatsHead;
+	while(*iter)
+	{
+		if(*iter == inStats)
+		{
+			*iter = inStats->next;
+			inStats->next = NULL;
+			return;
+		}
+		iter = &(*iter)->next;
+	}
+}
+
+void ring_stats_move(ring_stats_t* fromStats, ring_stats_t* toStats)
+{
+	ring_stats_t** iter = &sStatsHead;
+	*toStats = *fromStats;
+	toStats->next = NULL;
+	while(*iter)
+	{
+		if(*iter == fromStats)
+		{
+			toStats->next = fromStats->next;
+			*iter = toStats;
+			break;
+		}
+		iter = &(*iter)->next;
+	}
+	fromStats->next = NULL;
+}
+
+void ring_stats_log_all()
+{
+	for(ring_stats_t* iter = sStatsHead; iter; iter = iter->next)
+	{
+		LOG_STRING_ARGS(LOG_MODULE_CIRCULAR_BUFFER, LOG_SEVERITY_STATUS,
+				"%s: pushes %u, pops %u, overwrites %u, rejected %u, peak %u",
+				iter->name,
+				iter->pushes,
+				iter->pops,
+				iter->overwrites,
+				iter->rejected,
+				iter->peak);
+	}
+}
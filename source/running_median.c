@@ -0,0 +1,196 @@
+/*
+ * @file running_median.c
+ * @brief Project 6
+ *
+ * @details Running median from a max-heap and a min-heap sharing one array.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ *
+ *  LEVERAGED ALGORITHM FROM:
+ *  https://stackoverflow.com/a/5970314 (AShelly, "Mediator" running median)
+ */
+
+#include "running_median.h"
+
+/**
+ * Samples in the min-heap above the median and the max-heap below it.
+ * The heaps take turns growing as the window fills, max-heap first.
+ */
+static inline int32_t min_count(const running_median_t* inMedian)
+{
+	return ((int32_t)inMedian->count - 1) / 2;
+}
+
+static inline int32_t max_count(const running_median_t* inMedian)
+{
+	return (int32_t)inMedian->count / 2;
+}
+
+/**
+ * Whether the sample at heap index i is below the one at j.
+ */
+static inline int less(const running_median_t* inMedian, int32_t i, int32_t j)
+{
+	return inMedian->samples[inMedian->heap[i]] < inMedian->samples[inMedian->heap[j]];
+}
+
+/**
+ * Swap heap entries i and j if the sample at i is below the one at j.
+ * Returns whether they were swapped.
+ */
+static int exchange_if_less(running_median_t* inMedian, int32_t i, int32_t j)
+{
+	if(!less(inMedian, i, j))
+	{
+		return 0;
+	}
+	uint16_t slot = inMedian->heap[i];
+	inMedian->heap[i] = inMedian->heap[j];
+	inMedian->heap[j] = slot;
+	inMedian->positions[inMedian->heap[i]] = (int16_t)i;
+	inMedian->positions[inMedian->heap[j]] = (int16_t)j;
+	return 1;
+}
+
+/**
+ * The min-heap runs 1, 2, 3 ... with the children of i at 2i and 2i + 1,
+ * and the max-heap -1, -2, -3 ... with the children of i at 2i and 2i - 1.
+ * The median at 0 has one child on each side, the two roots, so a parent
+ * is always i / 2 rounded toward 0.
+ *
+ * Sift the sample at i away from the median while it is out of order.
+ */
+static void min_sift_down(running_median_t* inMedian, int32_t i)
+{
+	int32_t count = min_count(inMedian);
+	for(int32_t child = i ? 2 * i : 1; child <= count; child = 2 * i)
+	{
+		if(i && child < count && less(inMedian, child + 1, child))
+		{
+			child++;
+		}
+		if(!exchange_if_less(inMedian, child, i))
+		{
+			break;
+		}
+		i = child;
+	}
+}
+
+static void max_sift_down(running_median_t* inMedian, int32_t i)
+{
+	int32_t count = max_count(inMedian);
+	for(int32_t child = i ? 2 * i : -1; child >= -count; child = 2 * i)
+	{
+		if(i && child > -count && less(inMedian, child, child - 1))
+		{
+			child--;
+		}
+		if(!exchange_if_less(inMedian, i, child))
+		{
+			break;
+		}
+		i = child;
+	}
+}
+
+/**
+ * Sift up, returning whether the sample reached the median at 0.
+ */
+static int min_sift_up(running_median_t* inMedian, int32_t i)
+{
+	while(i > 0 && exchange_if_less(inMedian, i, i / 2))
+	{
+		i /= 2;
+	}
+	return i == 0;
+}
+
+static int max_sift_up(running_median_t* inMedian, int32_t i)
+{
+	while(i < 0 && exchange_if_less(inMedian, i / 2, i))
+	{
+		i /= 2;
+	}
+	return i == 0;
+}
+
+buff_err running_median_init(running_median_t* outMedian, uint16_t* inStorage, uint32_t inSize)
+{
+	if(!outMedian || !inStorage || !inSize || inSize > 65535u)
+	{
+		return buff_err_invalid;
+	}
+
+	outMedian->samples = inStorage;
+	outMedian->heap = inStorage + inSize + inSize / 2;
+	outMedian->positions = (int16_t*)(inStorage + 2 * inSize);
+	outMedian->size = inSize;
+	outMedian->count = 0;
+	outMedian->next = 0;
+
+	// slot k takes the place that extends the heaps to k + 1 samples: 0, -1, 1, -2, 2 ...
+	for(uint32_t slot = 0; slot < inSize; slot++)
+	{
+		int32_t position = (int32_t)(slot + 1) / 2;
+		position = (slot & 1) ? -position : position;
+		outMedian->positions[slot] = (int16_t)position;
+		outMedian->heap[position] = (uint16_t)slot;
+	}
+	return buff_err_success;
+}
+
+uint16_t running_median_push(running_median_t* inMedian, uint16_t inSample)
+{
+	uint32_t slot = inMedian->next;
+	int32_t position = inMedian->positions[slot];
+	uint16_t old = inMedian->samples[slot];
+	int filling = inMedian->count < inMedian->size;
+
+	inMedian->samples[slot] = inSample;
+	inMedian->next = slot + 1 == inMedian->size ? 0 : slot + 1;
+	inMedian->count += filling;
+
+	/**
+	 * The new sample takes the old one's place. A larger sample in the
+	 * min-heap, or a smaller one in the max-heap, only moves away from the
+	 * median. Otherwise it moves toward it, and if it reaches it, the
+	 * sample it displaced from the median moves into the other heap.
+	 * While filling there is no old sample, so it can go either way.
+	 */
+	if(position > 0)
+	{
+		if(!filling && old < inSample)
+		{
+			min_sift_down(inMedian, position);
+		}
+		else if(min_sift_up(inMedian, position))
+		{
+			max_sift_down(inMedian, 0);
+		}
+	}
+	else if(position < 0)
+	{
+		if(!filling && inSample < old)
+		{
+			max_sift_down(inMedian, position);
+		}
+		else if(max_sift_up(inMedian, position))
+		{
+			min_sift_down(inMedian, 0);
+		}
+	}
+	else
+	{
+		max_sift_down(inMedian, 0);
+		min_sift_down(inMedian, 0);
+	}
+
+	return running_median_value(inMedian);
+}
@@ -34,7 +34,6 @@
 #include "dac_adc.h"
 #include "MKL25Z4.h"
 #include "uart.h"
-#include "dma.h"
 
 #define UART_BAUD_RATE 115200
 
@@ -65,7 +64,6 @@ void initialize()
     sine_init();
     dac_init();
     adc_init();
-    dma_init(NULL);
     power_on_self_test();
 
     tasks_init();
@@ -2,7 +2,6 @@
 #include "logger.h"
 #include "handle_led.h"
 #include <math.h>
-#define NUM_SINE_SAMPLES 50
 #define INV_THREE_FACTORIAL (1/6)
 #define INV_FIVE_FACTORIAL (1/120)
 #define INV_SEVEN_FACTORIAL (1/5040)
@@ -31,12 +30,11 @@ void sine_init()
 {
 	// make a local sine function with taylor series
 	// try to figure out how to generate the lookup table above
-	uint64_t voltage_offset = 2;
 	// generate a sine wave, between 1V and 3V: sin(x) = A*sin(x)+2
 	LOG_STRING(LOG_MODULE_SINE, LOG_SEVERITY_STATUS, "Calculate and create a lookup table to represent the values in a sine wave that runs from 1V to 3V.");
 	for(int x =0; x < NUM_SINE_SAMPLES; x++)
 	{
-		sSineLookup[x] = (sin((2.0 * M_PI * (x/(float)(NUM_SINE_SAMPLES)))) + voltage_offset) * sDigitalConversionFactor;
+		sSineLookup[x] = (SINE_AMPLITUDE_MV * sin((2.0 * M_PI * (x/(float)(NUM_SINE_SAMPLES)))) + SINE_OFFSET_MV) / 1000.0 * sDigitalConversionFactor;
 		if(sSineLookup[x] > 4095)
 		{
 			set_led(1, RED);
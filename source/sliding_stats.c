@@ -0,0 +1,133 @@
+/*
+ * @file sliding_stats.c
+ * @brief Project 6
+ *
+ * @details Statistics over the last N samples, updated as each sample arrives.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "sliding_stats.h"
+
+buff_err sliding_stats_init(sliding_stats_t* outStats, uint16_t* inStorage, uint32_t inSize)
+{
+	if(!outStats || !inStorage || !inSize || inSize > 65536u)
+	{
+		return buff_err_invalid;
+	}
+
+	outStats->samples = inStorage;
+	outStats->size = inSize;
+	outStats->count = 0;
+	outStats->next = 0;
+	outStats->sum = 0;
+	outStats->sumSquares = 0;
+	outStats->minDeque.positions = inStorage + inSize;
+	outStats->minDeque.head = 0;
+	outStats->minDeque.length = 0;
+	outStats->maxDeque.positions = inStorage + 2 * inSize;
+	outStats->maxDeque.head = 0;
+	outStats->maxDeque.length = 0;
+	return buff_err_success;
+}
+
+/**
+ * Wrap an index below twice the window length back into the window.
+ * Avoids %, which is a library divide on the M0+.
+ */
+static inline uint32_t wrap(uint32_t inIndex, uint32_t inSize)
+{
+	return inIndex >= inSize ? inIndex - inSize : inIndex;
+}
+
+/**
+ * Positions at the front and back of a deque, and adding to the back.
+ */
+static inline uint16_t front(const sliding_deque_t* inDeque)
+{
+	return inDeque->positions[inDeque->head];
+}
+
+static inline uint16_t back(const sliding_deque_t* inDeque, uint32_t inSize)
+{
+	return inDeque->positions[wrap(inDeque->head + inDeque->length - 1, inSize)];
+}
+
+static inline void push_back(sliding_deque_t* inDeque, uint32_t inSize, uint32_t inPosition)
+{
+	inDeque->positions[wrap(inDeque->head + inDeque->length, inSize)] = (uint16_t)inPosition;
+	inDeque->length++;
+}
+
+static inline void pop_front(sliding_deque_t* inDeque, uint32_t inSize)
+{
+	inDeque->head = wrap(inDeque->head + 1, inSize);
+	inDeque->length--;
+}
+
+void sliding_stats_push(sliding_stats_t* inStats, uint16_t inSample)
+{
+	uint32_t size = inStats->size;
+	uint32_t position = inStats->next;
+
+	if(inStats->count == size)
+	{
+		// the oldest sample sits where this one goes. If it is still the
+		// min or max it is at the front of that deque, as the oldest entry.
+		uint32_t old = inStats->samples[position];
+		inStats->sum -= old;
+		inStats->sumSquares -= old * old;
+		if(front(&inStats->minDeque) == position)
+		{
+			pop_front(&inStats->minDeque, size);
+		}
+		if(front(&inStats->maxDeque) == position)
+		{
+			pop_front(&inStats->maxDeque, size);
+		}
+	}
+	else
+	{
+		inStats->count++;
+	}
+
+	inStats->samples[position] = inSample;
+	inStats->sum += inSample;
+	inStats->sumSquares += (uint32_t)inSample * inSample;
+
+	// drop everything the new sample outlives and beats
+	while(inStats->minDeque.length &&
+		  inStats->samples[back(&inStats->minDeque, size)] >= inSample)
+	{
+		inStats->minDeque.length--;
+	}
+	push_back(&inStats->minDeque, size, position);
+
+	while(inStats->maxDeque.length &&
+		  inStats->samples[back(&inStats->maxDeque, size)] <= inSample)
+	{
+		inStats->maxDeque.length--;
+	}
+	push_back(&inStats->maxDeque, size, position);
+
+	inStats->next = (position + 1 == size) ? 0 : position + 1;
+}
+
+void sliding_stats_snapshot(const sliding_stats_t* inStats, stream_stats_t* outStats)
+{
+	stream_stats_reset(outStats);
+	if(inStats->count)
+	{
+		outStats->count = inStats->count;
+		outStats->min = sliding_stats_min(inStats);
+		outStats->max = sliding_stats_max(inStats);
+		outStats->sum = inStats->sum;
+		outStats->sumSquares = inStats->sumSquares;
+	}
+}
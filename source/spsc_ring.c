@@ -0,0 +1,25 @@
+/*
+ * @file spsc_ring.c
+ * @brief Project 6
+ *
+ * @details A lock-free single-producer/single-consumer ring buffer for
+ *          handing data between an ISR and a task.
+ *
+ *          Instantiates the element widths declared in spsc_ring.h.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "spsc_ring.h"
+
+SPSC_RING_DEFINE(spsc_ring_u8, uint8_t)
+
+SPSC_RING_DEFINE(spsc_ring_u16, uint16_t)
+
+SPSC_RING_DEFINE(spsc_ring, uint32_t)
@@ -0,0 +1,118 @@
+/*
+ * @file stream_stats.c
+ * @brief Project 6
+ *
+ * @details Single-pass statistics over a stream of integer samples.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "stream_stats.h"
+#include "isqrt.h"
+
+void stream_stats_reset(stream_stats_t* outStats)
+{
+	outStats->count = 0;
+	outStats->min = INT32_MAX;
+	outStats->max = INT32_MIN;
+	outStats->sum = 0;
+	outStats->sumSquares = 0;
+}
+
+void stream_stats_add_block_u16(stream_stats_t* inStats, const uint16_t* inSamples, uint32_t inCount)
+{
+	// the sum of a block fits 32 bits, so only fold it into 64 bits once
+	uint32_t sum = 0;
+	uint64_t sumSquares = 0;
+	int32_t min = inStats->min;
+	int32_t max = inStats->max;
+	for(uint32_t i = 0; i < inCount; i++)
+	{
+		uint32_t sample = inSamples[i];
+		if((int32_t)sample < min)
+		{
+			min = sample;
+		}
+		if((int32_t)sample > max)
+		{
+			max = sample;
+		}
+		sum += sample;
+		sumSquares += sample * sample;
+	}
+	inStats->min = min;
+	inStats->max = max;
+	inStats->count += inCount;
+	inStats->sum += sum;
+	inStats->sumSquares += sumSquares;
+}
+
+void stream_stats_merge(stream_stats_t* inOutTotal, const stream_stats_t* inStats)
+{
+	if(inStats->min < inOutTotal->min)
+	{
+		inOutTotal->min = inStats->min;
+	}
+	if(inStats->max > inOutTotal->max)
+	{
+		inOutTotal->max = inStats->max;
+	}
+	inOutTotal->count += inStats->count;
+	inOutTotal->sum += inStats->sum;
+	inOutTotal->sumSquares += inStats->sumSquares;
+}
+
+uint64_t stream_stats_sum_squared_deviations(const stream_stats_t* inStats)
+{
+	uint32_t n = inStats->count;
+	if(!n)
+	{
+		return 0;
+	}
+
+	// sumSquares - sum^2 / n, without forming sum^2, which overflows 64 bits.
+	// With |sum| = q * n + r: sum^2 / n = q * |sum| + q * r + r^2 / n
+	uint64_t magnitude = inStats->sum < 0 ? (uint64_t)-inStats->sum : (uint64_t)inStats->sum;
+	uint64_t q = magnitude / n;
+	uint64_t r = magnitude % n;
+	uint64_t squareOverN = q * magnitude + q * r + (r * r + n - 1) / n;
+	return inStats->sumSquares > squareOverN ? inStats->sumSquares - squareOverN : 0;
+}
+
+uint64_t stream_stats_variance_q(const stream_stats_t* inStats, uint32_t inFractionBits)
+{
+	uint32_t n = inStats->count;
+	if(!n)
+	{
+		return 0;
+	}
+
+	// whole and fractional parts separately, so the shift cannot overflow
+	// for any sample within STREAM_STATS_MAX_MAGNITUDE
+	uint64_t deviations = stream_stats_sum_squared_deviations(inStats);
+	uint64_t whole = deviations / n;
+	uint64_t fraction = ((deviations % n) << inFractionBits) / n;
+	return (whole << inFractionBits) | fraction;
+}
+
+uint32_t stream_stats_stddev_q(const stream_stats_t* inStats, uint32_t inFractionBits)
+{
+	return isqrt64(stream_stats_variance_q(inStats, 2 * inFractionBits));
+}
+
+float stream_stats_mean(const stream_stats_t* inStats)
+{
+	return inStats->count ? (float)inStats->sum / (float)inStats->count : 0.0f;
+}
+
+float stream_stats_variance(const stream_stats_t* inStats)
+{
+	return inStats->count ?
+			(float)stream_stats_sum_squared_deviations(inStats) / (float)inStats->count : 0.0f;
+}
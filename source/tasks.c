@@ -10,8 +10,6 @@
  *         ARM Compiler: GNU gcc version 8.2.1 20181213
  *         ARM Linker: GNU ld 2.31.51.20181213
  *         ARM Debugger: GNU gdb 8.2.50.20181213-git
- *  LEVERAGED CODE: STANDARD DEVIATION https://www.sanfoundry.com/c-program-mean-variance-standard-deviation/
- *  Used to calculate standard deviation.
  */
 
 /* Kernel includes. */
@@ -22,15 +20,27 @@
 
 #include "post.h"
 #include "tasks.h"
-#include "circular_buffer.h"
+#include "pingpong.h"
+#include "stream_stats.h"
+#include "adc_stats.h"
+#include "dsp_stats.h"
+#include "sliding_stats.h"
+#include "running_median.h"
+#include "histogram.h"
+#include "fft.h"
+#include "goertzel.h"
+#include "adc_quality.h"
+#include "filter_chain.h"
+#include "decimator.h"
+#include "trigger.h"
+#include "ring_stats.h"
 #include "logger.h"
+#include "uart.h"
 #include "handle_led.h"
 #include "sine.h"
 #include "dac_adc.h"
-#include "dma.h"
+#include "cycle_count.h"
 #include "time.h"
-#include <float.h>
-#include <math.h>
 
 SemaphoreHandle_t xMutex;
 
@@ -50,38 +60,157 @@ static TimerHandle_t writeTimerHandle = NULL;
 static TimerHandle_t readTimerHandle = NULL;
 
 /**
- * Timestamp string for the start time of the last DMA transfer.
+ * Timestamp string for when the last block was handed to DSP.
  */
-static timestamp_str sLastDMAStart;
+static timestamp_str sLastBlockReady;
 
 /**
- * Timestamp string for the finish time of the last DMA transfer.
+ * Cycle count when the last block was handed to DSP.
  */
-static timestamp_str sLastDMAFinish;
+static volatile uint32_t sBlockReadyCycles;
 
 /**
- * Voltage reference for reading from the ADC.
+ * Samples per block handed from the ADC to DSP.
  */
-#define VREF_BRD 3.300
+#define BUFFER_CAPACITY 64
 
 /**
- * Max 12 bit float val for reading from the ADC.
+ * Rate the ADC read timer samples at, in mHz: one sample every 100 ms.
  */
-#define SE_12BIT 4096.0
+#define ADC_SAMPLE_RATE_MILLIHZ (1000000u / 100u)
 
 /**
- * Global buffer struct for the ADC and DSP buffers.
+ * Ping-pong blocks between the ADC reader and DSP. The ADC fills one
+ * block while DSP reads the other, so a handoff is a pointer swap.
+ * 12 bit samples are stored as half-words, placed in .bss at link time.
  */
-struct Buffers
-{
-	cbuf_handle_t adcBuffer;
-	cbuf_handle_t dspBuffer;
-} sBuffers;
+static pingpong_t sAdcBlocks;
+static uint16_t sAdcBlockStorage[2 * BUFFER_CAPACITY];
 
 /**
- * Size of ADC and DSP buffers.
+ * Trigger that decides which samples reach DSP. Free run hands over every
+ * sample, as before; the other modes hand over only captures around the
+ * trigger point, like an oscilloscope. Levels are in mV at the ADC input.
  */
-#define BUFFER_CAPACITY 64
+#ifndef ADC_TRIGGER_MODE
+#define ADC_TRIGGER_MODE trigger_mode_free_run
+#endif
+#ifndef ADC_TRIGGER_LEVEL_MV
+#define ADC_TRIGGER_LEVEL_MV SINE_OFFSET_MV
+#endif
+#ifndef ADC_TRIGGER_HYSTERESIS_MV
+#define ADC_TRIGGER_HYSTERESIS_MV 50
+#endif
+#ifndef ADC_TRIGGER_LOW_MV
+#define ADC_TRIGGER_LOW_MV (SINE_OFFSET_MV - SINE_AMPLITUDE_MV - 100)
+#endif
+#ifndef ADC_TRIGGER_HIGH_MV
+#define ADC_TRIGGER_HIGH_MV (SINE_OFFSET_MV + SINE_AMPLITUDE_MV + 100)
+#endif
+#ifndef ADC_TRIGGER_PRE
+#define ADC_TRIGGER_PRE (BUFFER_CAPACITY / 4)
+#endif
+#ifndef ADC_TRIGGER_HOLDOFF
+#define ADC_TRIGGER_HOLDOFF 0
+#endif
+#ifndef ADC_TRIGGER_AUTO
+#define ADC_TRIGGER_AUTO (2 * BUFFER_CAPACITY) // force a capture when nothing triggers, 0 waits forever
+#endif
+
+#if ADC_TRIGGER_PRE >= BUFFER_CAPACITY
+#error "the pre-trigger history must leave room for the trigger sample"
+#endif
+
+static trigger_t sAdcTrigger;
+static uint16_t sAdcTriggerHistory[ADC_TRIGGER_PRE ? ADC_TRIGGER_PRE : 1];
+
+/**
+ * Samples in the sliding window that read_adc0_task keeps up to date.
+ */
+#ifndef ADC_WINDOW_SIZE
+#define ADC_WINDOW_SIZE 16
+#endif
+
+/**
+ * Statistics over the latest ADC_WINDOW_SIZE samples, updated per sample,
+ * so current values are available between blocks.
+ */
+static sliding_stats_t sAdcWindow;
+static uint16_t sAdcWindowStorage[SLIDING_STATS_STORAGE(ADC_WINDOW_SIZE)];
+
+/**
+ * Samples in the running median that rejects glitches from the reported
+ * min and max. 0 leaves it out.
+ */
+#ifndef ADC_MEDIAN_WINDOW
+#define ADC_MEDIAN_WINDOW 5
+#endif
+
+#if ADC_MEDIAN_WINDOW
+static running_median_t sAdcMedian;
+static uint16_t sAdcMedianStorage[RUNNING_MEDIAN_STORAGE(ADC_MEDIAN_WINDOW)];
+
+/**
+ * Statistics of the median-filtered samples since boot.
+ */
+static stream_stats_t sDespikedStats;
+#endif
+
+#if ADC_OVERSAMPLE_RATIO > 1
+#if 100 % ADC_OVERSAMPLE_RATIO || ADC_OVERSAMPLE_RATIO > DECIMATOR_MAX_RATIO
+#error "ADC_OVERSAMPLE_RATIO must divide the 100 ms period and fit the CIC"
+#endif
+
+/**
+ * Turns ADC_OVERSAMPLE_RATIO conversions into each sample that is reported.
+ */
+static decimator_t sAdcDecimator;
+#endif
+
+#if DSP_FFT_ANALYSIS
+#if BUFFER_CAPACITY != FFT_SIZE
+#error "FFT_LOG2_SIZE must match BUFFER_CAPACITY"
+#endif
+
+/**
+ * Scratch for the spectrum of each block, so the block itself is left alone.
+ */
+static q15_t sFftWork[FFT_WORK_LENGTH];
+#endif
+
+#if FILTER_CHAIN_STAGES && BUFFER_CAPACITY > FILTER_CHAIN_MAX_BLOCK
+#error "FILTER_CHAIN_MAX_BLOCK must hold a whole block"
+#endif
+
+#if DSP_GOERTZEL_ANALYSIS
+/**
+ * Samples the stimulus is measured over: whole periods of the sine, since
+ * the ADC reads each DAC sample once, so the tones fall exactly on target.
+ */
+#define STIMULUS_LENGTH ((BUFFER_CAPACITY / NUM_SINE_SAMPLES) * NUM_SINE_SAMPLES)
+#if STIMULUS_LENGTH == 0
+#error "a block must hold at least one period of the sine"
+#endif
+
+/**
+ * The stimulus fundamental and its second and third harmonics.
+ */
+#define STIMULUS_TARGETS 3
+static const goertzel_target_t sStimulusTargets[STIMULUS_TARGETS] = {
+	GOERTZEL_TARGET(STIMULUS_LENGTH / NUM_SINE_SAMPLES, STIMULUS_LENGTH, STIMULUS_LENGTH),
+	GOERTZEL_TARGET(2 * STIMULUS_LENGTH / NUM_SINE_SAMPLES, STIMULUS_LENGTH, STIMULUS_LENGTH),
+	GOERTZEL_TARGET(3 * STIMULUS_LENGTH / NUM_SINE_SAMPLES, STIMULUS_LENGTH, STIMULUS_LENGTH),
+};
+#endif
+
+/**
+ * Sign, whole part and hundredths of a value kept in hundredths,
+ * for a "%s%u.%02u" format.
+ */
+#define CENTI_ARGS(inValue) \
+	((inValue) < 0 ? "-" : ""), \
+	(uint32_t)((inValue) < 0 ? -(inValue) : (inValue)) / 100u, \
+	(uint32_t)((inValue) < 0 ? -(inValue) : (inValue)) % 100u
 
 /**
  * Number of runs for program 2.
@@ -103,143 +232,355 @@ void write_dac0_task(TimerHandle_t xTimer);
 void read_adc0_task(TimerHandle_t xTimer);
 
 
+/**
+ * One shot timer that turns the blue LED off after a handoff. Created once,
+ * and restarted for each block, so handoffs do not allocate.
+ */
+static TimerHandle_t sHandoffLedTimer = NULL;
+
 /**
  * One shot timer task to turn off the blue LED.
  */
-void turn_off_dma_led(void *pvParameters)
+void turn_off_handoff_led(void *pvParameters)
 {
-	LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Turn off blue LED triggered by DMA transfer, release mutex.");
+	LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Turn off blue LED triggered by block handoff, release mutex.");
 	set_led(0, BLUE);
 	xSemaphoreGive(xMutex);
 }
 
 /**
- * A task that analyzes the DSP buffer after each DMA transfer.
+ * Statistics of the last block and of everything sampled since boot, in ADC codes.
+ */
+static stream_stats_t sBlockStats;
+static stream_stats_t sLifetimeStats;
+
+#if DSP_HISTOGRAM_ANALYSIS
+/**
+ * Distribution of the codes in the last block and since boot, for percentiles.
  */
-void dsp_callback(void *pvParameters)
+static histogram_t sBlockHistogram;
+static histogram_t sLifetimeHistogram;
+
+/**
+ * Shares of the samples reported, in hundredths of a percent.
+ */
+#define HISTOGRAM_PERCENTILES 3
+static const uint32_t sPercentiles[HISTOGRAM_PERCENTILES] = { 5000, 9500, 9900 };
+
+/**
+ * Log p50, p95 and p99 of a histogram in mV.
+ */
+static void log_percentiles(const char* inName, const histogram_t* inHistogram)
 {
+	uint32_t mv[HISTOGRAM_PERCENTILES];
+	for(uint32_t i = 0; i < HISTOGRAM_PERCENTILES; i++)
+	{
+		uint16_t code = 0;
+		histogram_percentile(inHistogram, sPercentiles[i], &code);
+		mv[i] = adc_code_to_mv(code);
+	}
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "%s percentiles of %u samples: p50 %u mV, p95 %u mV, p99 %u mV",
+			inName,
+			(uint32_t)histogram_samples(inHistogram),
+			mv[0],
+			mv[1],
+			mv[2]);
+}
+#endif
+
+/**
+ * The long-lived DSP task, woken by a notification for each block.
+ */
+static TaskHandle_t sDspTaskHandle = NULL;
+
+/**
+ * Analyzes the block handed over by the ADC. Runs in the DSP task.
+ */
+void dsp_callback()
+{
+	uint32_t handoffCycles = cycle_count_now() - sBlockReadyCycles;
+
 	static uint8_t sRunNumber = 0;
-	static float sMaxVoltage = 0;
-	static float sMinVoltage = FLT_MAX;
-	static float sAverageVoltage = 0;
-	static float sVoltagesCumulative = 0;
-	static float sNumVoltagesRecorded = 0;
 
-	static float sVarianceSum = 0;
-	static float sVariance = 0;
-	static float sStDeviationVoltage = 0;
+	// a spurious or coalesced wake finds no block: not a run, nothing to report
+	size_t count = 0;
+	uint16_t* block = pingpong_acquire(&sAdcBlocks, &count);
+	if(!block || !count)
+	{
+		return;
+	}
 
 	sRunNumber++;
 
-	float voltages[BUFFER_CAPACITY] = {0.0f};
-
 	/**
-	 * Calculate the following floating point values
+	 * Calculate the following values
 	 * from the ADC register values:  maximum,  minimum, average,
 	 * and standard deviation of voltage levels.
+	 *
+	 * The block is reduced on raw codes in one pass, while it belongs to us
+	 * until released, and only the results are converted to millivolts.
 	 */
-
-	uint32_t data;
-	uint32_t i = 0;
-	while(circular_buf_pop(sBuffers.dspBuffer, &data) == buff_err_success)
+	uint32_t statsStart = cycle_count_now();
+#if FILTER_CHAIN_STAGES || DSP_STATS_USE_CMSIS
+	// 12 bit codes are non-negative Q15 values, for the kernels that work in place
+	q15_t* samples = (q15_t*)block;
+#endif
+#if FILTER_CHAIN_STAGES
+	// filter the block in place, so everything below sees the filtered samples
+	uint32_t filterCycles = filter_chain_process(samples, count);
+#endif
+	stream_stats_reset(&sBlockStats);
+	stream_stats_add_block_u16(&sBlockStats, block, count);
+#if DSP_HISTOGRAM_ANALYSIS
+	uint32_t histogramStart = cycle_count_now();
+	histogram_reset(&sBlockHistogram);
+	histogram_add_block_u16(&sBlockHistogram, block, count);
+	uint32_t histogramCycles = cycle_count_now() - histogramStart;
+#endif
+#if ADC_MEDIAN_WINDOW
+	// a glitch shorter than half the window never reaches the median
+	uint32_t medianStart = cycle_count_now();
+	for(size_t i = 0; i < count; i++)
 	{
-		sNumVoltagesRecorded++;
-
-        // convert to float
-		float voltage = (float)(data * (VREF_BRD / SE_12BIT));
-
-		// calc max
-		if(voltage > sMaxVoltage)
-		{
-			sMaxVoltage = voltage;
-		}
-
-		// calc min
-		if(voltage < sMinVoltage)
-		{
-			sMinVoltage = voltage;
-		}
-		// calc avg
-		sVoltagesCumulative += voltage;
-		sAverageVoltage = (sVoltagesCumulative)/sNumVoltagesRecorded;
-
-		voltages[i] = voltage;
-		i++;
+		stream_stats_add(&sDespikedStats, running_median_push(&sAdcMedian, block[i]));
 	}
+	uint32_t medianCycles = cycle_count_now() - medianStart;
+#endif
+#if DSP_GOERTZEL_ANALYSIS
+	// the block mean as the offset keeps the filter state small
+	goertzel_result_t stimulus[STIMULUS_TARGETS];
+	uint32_t goertzelStart = cycle_count_now();
+	buff_err stimulusErr = goertzel_block_u16(block, count,
+			(int32_t)((sBlockStats.sum + count / 2) / count),
+			sStimulusTargets, STIMULUS_TARGETS, stimulus);
+	uint32_t goertzelCycles = cycle_count_now() - goertzelStart;
+#endif
+#if ADC_QUALITY_ANALYSIS
+	adc_quality_t quality;
+	uint32_t qualityStart = cycle_count_now();
+	buff_err qualityErr = adc_quality_measure(block, count, &quality);
+	uint32_t qualityCycles = cycle_count_now() - qualityStart;
+#endif
+#if DSP_FFT_ANALYSIS
+	// before the CMSIS kernels, which scale the block in place
+	fft_analysis_t spectrum;
+	buff_err spectrumErr = fft_analyze_block_u16(block, count, ADC_SAMPLE_RATE_MILLIHZ, sFftWork, &spectrum);
+#endif
+#if DSP_STATS_USE_CMSIS
+	// the block is ours until released, so the kernels may scale it in place
+	dsp_block_stats_t kernelStats;
+	dsp_block_stats_q15(samples, count, DSP_STATS_ADC_HEADROOM, &kernelStats);
+#endif
+	pingpong_release(&sAdcBlocks);
+	stream_stats_merge(&sLifetimeStats, &sBlockStats);
+#if DSP_HISTOGRAM_ANALYSIS
+	histogram_merge(&sLifetimeHistogram, &sBlockHistogram);
+#endif
 
-    /*  Compute  variance  and standard deviation  */
-    for (int iter = 0; iter < BUFFER_CAPACITY; iter++)
-    {
-    	float voltage_entry = (voltages[iter] - sAverageVoltage);
-		sVarianceSum = sVarianceSum + (voltage_entry * voltage_entry); // cheap square
-    }
-    sVariance = sVarianceSum / (float)sNumVoltagesRecorded;
-    sStDeviationVoltage = sqrt(sVariance); //TODO remove if we can't afford this
+	adc_stats_report_t lifetime;
+	adc_stats_report_t blockReport;
+	adc_stats_report(&sLifetimeStats, &lifetime);
+	adc_stats_report(&sBlockStats, &blockReport);
+#if DSP_STATS_USE_CMSIS
+	blockReport.meanMv = adc_code_to_mv(kernelStats.mean);
+	blockReport.stdDevMv = adc_span_to_mv(kernelStats.stdDev);
+#endif
+	// the window is written by the timer task, so copy it in one piece
+	stream_stats_t window;
+	adc_stats_report_t windowReport;
+	taskENTER_CRITICAL();
+	sliding_stats_snapshot(&sAdcWindow, &window);
+	taskEXIT_CRITICAL();
+	adc_stats_report(&window, &windowReport);
+	uint32_t statsDone = cycle_count_now();
+	uint32_t statsCycles = statsDone - statsStart;
+	uint32_t readyToDoneCycles = statsDone - sBlockReadyCycles;
 
 	/**
 	 * Report those values along with an incremented run number
-	 * starting at 1 and the start time and end time for the last DMA transfer.
+	 * starting at 1, when the block was handed over and how long DSP took to start.
 	 */
 	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Run #%d",
 			sRunNumber);
 
-	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Last DMA start: [ %s%s%s%s ]:",
-			sLastDMAStart.hours,
-			sLastDMAStart.mins,
-			sLastDMAStart.secs,
-			sLastDMAStart.tens);
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Last block ready: [ %s%s%s%s ]:",
+			sLastBlockReady.hours,
+			sLastBlockReady.mins,
+			sLastBlockReady.secs,
+			sLastBlockReady.tens);
 
-	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Last DMA finish: [ %s%s%s%s ]:",
-			sLastDMAFinish.hours,
-			sLastDMAFinish.mins,
-			sLastDMAFinish.secs,
-			sLastDMAFinish.tens);
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Block ready to DSP start: %u cycles (%u us), %u blocks dropped",
+			handoffCycles,
+			cycle_count_to_us(handoffCycles),
+			sAdcBlocks.overruns);
+
+	// free run has no trigger point, so only the other modes report captures.
+	// The counts are single words, so reading them while the ADC timer runs is safe.
+	if(ADC_TRIGGER_MODE != trigger_mode_free_run)
+	{
+		LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Capture: %u samples before the trigger, %u triggered, %u automatic",
+				ADC_TRIGGER_PRE,
+				sAdcTrigger.triggers,
+				sAdcTrigger.forced);
+	}
 
 	// report max
-	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Maximum voltage: %f", sMaxVoltage);
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Maximum voltage: %u mV", lifetime.maxMv);
 
 	// report min
-	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Minimum voltage: %f", sMinVoltage);
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Minimum voltage: %u mV", lifetime.minMv);
 
 	// report avg
-	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Average voltage: %f", sAverageVoltage);
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Average voltage: %u mV", lifetime.meanMv);
 
 	// report st deviation
-	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Standard deviation voltage: %f", sStDeviationVoltage);
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Standard deviation voltage: %u mV", lifetime.stdDevMv);
+
+	// report this block alone
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Block average voltage: %u mV, standard deviation: %u mV",
+			blockReport.meanMv,
+			blockReport.stdDevMv);
+
+#if DSP_HISTOGRAM_ANALYSIS
+	// report the shape of the distribution, which the mean and deviation hide
+	log_percentiles("Block", &sBlockHistogram);
+	log_percentiles("Lifetime", &sLifetimeHistogram);
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Histogram of %u bins of %u codes took %u cycles",
+			HISTOGRAM_BINS,
+			HISTOGRAM_BIN_WIDTH,
+			histogramCycles);
+#endif
+
+#if ADC_MEDIAN_WINDOW
+	// report min and max with glitches rejected, and what that cost
+	uint32_t medianCentiCycles = count ? medianCycles * 100u / count : 0;
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Median of %u: minimum voltage %u mV, maximum voltage %u mV, %u.%02u cycles per sample",
+			ADC_MEDIAN_WINDOW,
+			adc_code_to_mv(sDespikedStats.min),
+			adc_code_to_mv(sDespikedStats.max),
+			medianCentiCycles / 100u,
+			medianCentiCycles % 100u);
+#endif
+
+	// report the sliding window
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Last %u samples: min %u mV, max %u mV, average %u mV, standard deviation %u mV",
+			windowReport.count,
+			windowReport.minMv,
+			windowReport.maxMv,
+			windowReport.meanMv,
+			windowReport.stdDevMv);
+
+#if FILTER_CHAIN_STAGES
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Filter chain: %u stages took %u cycles",
+			FILTER_CHAIN_STAGES,
+			filterCycles);
+#endif
+
+#if DSP_FFT_ANALYSIS
+	// report the spectrum of this block
+	if(spectrumErr == buff_err_success)
+	{
+		LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Spectrum: fundamental %u.%03u Hz (bin %u), amplitude %u mV, DC %u mV, THD %u.%02u %%",
+				spectrum.fundamentalMilliHz / 1000u,
+				spectrum.fundamentalMilliHz % 1000u,
+				spectrum.peakBin,
+				adc_span_to_mv(spectrum.amplitude),
+				adc_code_to_mv(spectrum.dcOffset),
+				spectrum.thdPpm / 10000u,
+				(spectrum.thdPpm / 100u) % 100u);
+	}
+#endif
+
+#if DSP_GOERTZEL_ANALYSIS
+	// report the stimulus tone, phase from the first sample of the block
+	if(stimulusErr == buff_err_success)
+	{
+		LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Stimulus: %u mV at %s%u.%02u deg, 2nd harmonic %u mV, 3rd harmonic %u mV, took %u cycles",
+				adc_span_to_mv(stimulus[0].amplitude),
+				CENTI_ARGS(stimulus[0].phaseCentiDeg),
+				adc_span_to_mv(stimulus[1].amplitude),
+				adc_span_to_mv(stimulus[2].amplitude),
+				goertzelCycles);
+	}
+#endif
+
+#if ADC_QUALITY_ANALYSIS
+	// report how well the ADC reproduces the stimulus
+	if(qualityErr == buff_err_success)
+	{
+		LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "ADC quality over %u samples: SNR %s%u.%02u dB, SINAD %s%u.%02u dB, ENOB %s%u.%02u bits, gain error %d ppm, offset error %d uV, took %u cycles",
+				quality.samples,
+				CENTI_ARGS(quality.snrCentiDb),
+				CENTI_ARGS(quality.sinadCentiDb),
+				CENTI_ARGS(quality.enobCentiBits),
+				quality.gainErrorPpm,
+				quality.offsetErrorUv,
+				qualityCycles);
+	}
+#endif
+
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Statistics took %u cycles, block ready to stats done: %u cycles (%u us)",
+			statsCycles,
+			readyToDoneCycles,
+			cycle_count_to_us(readyToDoneCycles));
+
+	// with one long-lived DSP task this should hold steady from run to run
+	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Free heap: %u bytes, lowest ever: %u bytes",
+			xPortGetFreeHeapSize(),
+			xPortGetMinimumEverFreeHeapSize());
 
 	/**
 	 * Once run number 5 is completed and reported, terminate the
-	 * DAC and ADC tasks, and terminate this task to end the program.
+	 * DAC and ADC tasks. With no more blocks coming, the DSP task
+	 * stays blocked, which ends the program.
 	 */
 	if(sRunNumber >= NUM_RUNS)
 	{
 		LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Exiting app.", sRunNumber);
+		ring_stats_log_all();
+#if FILTER_CHAIN_STAGES
+		filter_chain_log();
+#endif
 
 		xTimerStop(writeTimerHandle, 0);
 		xTimerStop(readTimerHandle, 0);
 	}
-
-	vTaskDelete(NULL);
 }
 
 /**
- * Callback for when the DMA transfer has completed.
+ * Sleeps until the ADC hands over a block, then analyzes it.
+ * Created once, so there is no heap allocation or task setup per block.
  */
-void DMA_Callback()
+void dsp_task(void *pvParameters)
 {
-	// copies buffer state, not data
-	circular_buf_copy(sBuffers.adcBuffer, sBuffers.dspBuffer);
-	circular_buf_reset(sBuffers.adcBuffer);
-	LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "DMA Transfer completed.");
+	for(;;)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		dsp_callback();
+	}
+}
 
-	timestamp_now(&sLastDMAFinish);
+/**
+ * Sleeps until a character arrives on the UART, then echoes it.
+ * With USE_UART_INTERRUPTS the receive ISR wakes it through the ring.
+ */
+void uart_echo_task(void *pvParameters)
+{
+	uint8_t ch;
+	for(;;)
+	{
+		uart_echo_wait(&ch, portMAX_DELAY);
+	}
+}
 
-	if(xTaskCreate(dsp_callback, "DSP Callback", configMINIMAL_STACK_SIZE + 512, NULL, (configMAX_PRIORITIES - 1), NULL) != pdPASS)
+/**
+ * Called when a full block has been handed over to DSP.
+ */
+void block_ready()
+{
+	if(sDspTaskHandle)
 	{
-		LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "DSP task creation failed.");
-	    xSemaphoreTake(xMutex, pdMS_TO_TICKS(1000));
-		set_led(1, RED);
-		xSemaphoreGive(xMutex);
+		xTaskNotifyGive(sDspTaskHandle);
 	}
 }
 
@@ -265,18 +606,73 @@ void tasks_init()
     LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Create .1 second timer to read sine values from the ADC.");
     /* Create the software timer. */
     readTimerHandle = xTimerCreate("ADC READ Timer",          /* Text name. */
-    		                     pdMS_TO_TICKS(100), /* Timer period. */
+    		                     pdMS_TO_TICKS(100 / ADC_OVERSAMPLE_RATIO), /* Timer period. */
                                  pdTRUE,             /* Enable auto reload. */
                                  0,                  /* ID is not used. */
 								 read_adc0_task);   /* The callback function. */
     xTimerStart(readTimerHandle, 0);
 
+    sHandoffLedTimer = xTimerCreate("Handoff LED timer",          /* Text name. */
+    		                        pdMS_TO_TICKS(500), /* Timer period. */
+                                    pdFALSE,             /* Enable auto reload. */
+                                    0,                  /* ID is not used. */
+                                    turn_off_handoff_led);   /* The callback function. */
+    if(!sHandoffLedTimer)
+    {
+		LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Handoff LED timer creation failed.");
+		set_led(1, RED);
+    }
+
     LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Create DSP and ADC buffers.");
-    sBuffers.adcBuffer = circular_buf_init(BUFFER_CAPACITY);
-    sBuffers.dspBuffer = circular_buf_init(BUFFER_CAPACITY);
-    // need to init post-scheduler start
-    //xTaskCreate(dma_init, "DMA Init", configMINIMAL_STACK_SIZE + 512, NULL, (configMAX_PRIORITIES - 1), NULL);
+    pingpong_init(&sAdcBlocks, sAdcBlockStorage, BUFFER_CAPACITY);
+    stream_stats_reset(&sLifetimeStats);
+#if DSP_HISTOGRAM_ANALYSIS
+    histogram_reset(&sLifetimeHistogram);
+#endif
+    sliding_stats_init(&sAdcWindow, sAdcWindowStorage, ADC_WINDOW_SIZE);
+    const trigger_config_t triggerConfig = {
+    	.mode = ADC_TRIGGER_MODE,
+    	// converted with the calibration in force now, as the trigger compares raw codes
+    	.level = adc_mv_to_code(ADC_TRIGGER_LEVEL_MV),
+    	.hysteresis = adc_mv_to_span(ADC_TRIGGER_HYSTERESIS_MV),
+    	.low = adc_mv_to_code(ADC_TRIGGER_LOW_MV),
+    	.high = adc_mv_to_code(ADC_TRIGGER_HIGH_MV),
+    	.preTrigger = ADC_TRIGGER_PRE,
+    	.holdoff = ADC_TRIGGER_HOLDOFF,
+    	.autoTimeout = ADC_TRIGGER_AUTO
+    };
+    if(trigger_init(&sAdcTrigger, &triggerConfig, sAdcTriggerHistory, BUFFER_CAPACITY) != buff_err_success)
+    {
+		LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Trigger settings rejected.");
+		set_led(1, RED);
+    }
+#if ADC_MEDIAN_WINDOW
+    running_median_init(&sAdcMedian, sAdcMedianStorage, ADC_MEDIAN_WINDOW);
+    stream_stats_reset(&sDespikedStats);
+#endif
+#if FILTER_CHAIN_STAGES
+    filter_chain_init();
+#endif
+#if ADC_OVERSAMPLE_RATIO > 1
+    decimator_init(&sAdcDecimator, ADC_OVERSAMPLE_RATIO);
 #endif
+
+    LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Create DSP task.");
+    if(xTaskCreate(dsp_task, "DSP", configMINIMAL_STACK_SIZE + 512, NULL, (configMAX_PRIORITIES - 1), &sDspTaskHandle) != pdPASS)
+    {
+		// with nothing to hand blocks to, stop sampling rather than notify no one
+		LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "DSP task creation failed.");
+		set_led(1, RED);
+		sDspTaskHandle = NULL;
+		xTimerStop(readTimerHandle, 0);
+    }
+#endif
+
+    LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Create UART echo task.");
+    if(xTaskCreate(uart_echo_task, "UART echo", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL) != pdPASS)
+    {
+		LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "UART echo task creation failed.");
+    }
     /* Start scheduling. */
     vTaskStartScheduler();
 }
@@ -318,44 +714,41 @@ void read_adc0_task(TimerHandle_t xTimer)
 	 raw ADC register values from each read.
     */
 
-	uint32_t sample = read_adc();
+	uint16_t sample = (uint16_t)read_adc();
+#if ADC_OVERSAMPLE_RATIO > 1
+	// only every ADC_OVERSAMPLE_RATIO-th conversion completes a sample
+	uint16_t decimated;
+	if(!decimator_push(&sAdcDecimator, sample, &decimated))
+	{
+		return;
+	}
+	// the blocks hold 12 bit codes, so the fraction bits are rounded away
+	// here: averaging lowers the noise but does not add resolution
+	sample = decimator_to_code(decimated);
+#endif
 	LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_DEBUG, "Reading %d from the ADC.", sample);
-	if(circular_buf_push(sBuffers.adcBuffer, sample) == buff_err_full)
+	sliding_stats_push(&sAdcWindow, sample);
+	if(trigger_push(&sAdcTrigger, &sAdcBlocks, sample))
 	{
-		 // When the buffer is full, initiate a DMA transfer from the ADC buffer to a second
-		 // buffer (called the DSP buffer).
+		// The capture just completed and now belongs to DSP. The ADC keeps
+		// sampling into the other block, so no copy is needed.
+		sBlockReadyCycles = cycle_count_now();
+		timestamp_now(&sLastBlockReady);
+
 		/*
-		 When the DMA Transfer is about to start, toggle the LED to Blue for .5 seconds.
+		 When a block is handed off, toggle the LED to Blue for .5 seconds.
 		 During this period, the LED cannot be used by other tasks.
-
-		 Capture a time stamp at the start and completion of the DMA transfer.
 		 */
-		LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Turn on blue LED triggered by DMA transfer, acquire mutex.");
-	    xSemaphoreTake(xMutex, pdMS_TO_TICKS(1000));
-		set_led(1, BLUE);
-	    TimerHandle_t startTransferTimer = NULL;
-	    startTransferTimer = xTimerCreate("Start DMA timer",          /* Text name. */
-	    		                          pdMS_TO_TICKS(500), /* Timer period. */
-	                                      pdFALSE,             /* Enable auto reload. */
-	                                      0,                  /* ID is not used. */
-										  turn_off_dma_led);   /* The callback function. */
-	    xTimerStart(startTransferTimer, 0);
-
-	    timestamp_now(&sLastDMAStart);
-	    LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "DMA Transfer started.");
-	    dma_transfer(sBuffers.adcBuffer->buffer,
-	    		     sBuffers.dspBuffer->buffer,
-					 BUFFER_CAPACITY,
-					 DMA_Callback);
-
-	    LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_DEBUG, "DMA Transfer claimed to complete.");
-	}
+		if(sHandoffLedTimer)
+		{
+			LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Turn on blue LED triggered by block handoff, acquire mutex.");
+		    xSemaphoreTake(xMutex, pdMS_TO_TICKS(1000));
+			set_led(1, BLUE);
+		    xTimerStart(sHandoffLedTimer, 0);
+		}
 
-	/*
-	 Clear (or overwrite) the ADC buffer with incoming DAC values and continue sampling
-	 until the next series of samples are collected.
+	    LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Block handed to DSP.");
+	    block_ready();
+	}
 
-	 You will need to consider the size and data width requirements for the ADC
-	 buffer and the DSP buffer.
-	 */
 }
@@ -0,0 +1,151 @@
+/*
+ * @file trigger.c
+ * @brief Project 6
+ *
+ * @details Oscilloscope-style trigger and pre/post-trigger capture.
+ *
+ * @author Jack Campbell
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ *         ARM Compiler: GNU gcc version 8.2.1 20181213
+ *         ARM Linker: GNU ld 2.31.51.20181213
+ *         ARM Debugger: GNU gdb 8.2.50.20181213-git
+ */
+
+#include "trigger.h"
+
+buff_err trigger_init(trigger_t* outTrigger, const trigger_config_t* inConfig,
+		              uint16_t* inHistory, uint32_t inBlockSize)
+{
+	if(!outTrigger || !inConfig || inConfig->preTrigger >= inBlockSize ||
+	   (inConfig->preTrigger && !inHistory) ||
+	   (inConfig->mode == trigger_mode_window && inConfig->low > inConfig->high) ||
+	   inConfig->mode > trigger_mode_window)
+	{
+		return buff_err_invalid;
+	}
+
+	outTrigger->config = *inConfig;
+	outTrigger->history = inHistory;
+	outTrigger->historyFill = 0;
+	outTrigger->historyNext = 0;
+	outTrigger->postLeft = 0;
+	outTrigger->holdoffLeft = 0;
+	outTrigger->waiting = 0;
+	outTrigger->edgeArmed = false;
+	outTrigger->triggers = 0;
+	outTrigger->forced = 0;
+	return buff_err_success;
+}
+
+/**
+ * Whether inSample meets the trigger condition. Edge modes also track
+ * whether the signal has left the hysteresis band, so this runs on every
+ * sample outside a capture, armed or not.
+ */
+static bool condition(trigger_t* inTrigger, uint16_t inSample)
+{
+	const trigger_config_t* config = &inTrigger->config;
+	switch(config->mode)
+	{
+		case trigger_mode_free_run:
+			return true;
+		case trigger_mode_level:
+			return inSample >= config->level;
+		case trigger_mode_rising:
+			if(inSample >= config->level)
+			{
+				bool fire = inTrigger->edgeArmed;
+				inTrigger->edgeArmed = false;
+				return fire;
+			}
+			if((uint32_t)inSample + config->hysteresis < config->level)
+			{
+				inTrigger->edgeArmed = true;
+			}
+			return false;
+		case trigger_mode_falling:
+			if(inSample <= config->level)
+			{
+				bool fire = inTrigger->edgeArmed;
+				inTrigger->edgeArmed = false;
+				return fire;
+			}
+			if(inSample > (uint32_t)config->level + config->hysteresis)
+			{
+				inTrigger->edgeArmed = true;
+			}
+			return false;
+		case trigger_mode_window:
+			return inSample < config->low || inSample > config->high;
+	}
+	return false;
+}
+
+bool trigger_push(trigger_t* inTrigger, pingpong_t* inOut, uint16_t inSample)
+{
+	uint32_t pre = inTrigger->config.preTrigger;
+
+	if(inTrigger->postLeft)
+	{
+		bool handed = pingpong_push(inOut, inSample);
+		if(--inTrigger->postLeft == 0)
+		{
+			// the history restarts from here, so every capture has its own
+			inTrigger->holdoffLeft = inTrigger->config.holdoff;
+			inTrigger->historyFill = 0;
+			inTrigger->historyNext = 0;
+		}
+		return handed;
+	}
+
+	bool fire = condition(inTrigger, inSample);
+	if(inTrigger->holdoffLeft)
+	{
+		inTrigger->holdoffLeft--;
+		fire = false;
+	}
+	else if(inTrigger->historyFill == pre)
+	{
+		uint32_t timeout = inTrigger->config.autoTimeout;
+		if(fire)
+		{
+			inTrigger->triggers++;
+		}
+		else if(timeout && ++inTrigger->waiting >= timeout)
+		{
+			inTrigger->forced++;
+			fire = true;
+		}
+	}
+	else
+	{
+		fire = false;
+	}
+
+	if(!fire)
+	{
+		if(pre)
+		{
+			inTrigger->history[inTrigger->historyNext] = inSample;
+			inTrigger->historyNext = (inTrigger->historyNext + 1 == pre) ? 0 : inTrigger->historyNext + 1;
+			if(inTrigger->historyFill < pre)
+			{
+				inTrigger->historyFill++;
+			}
+		}
+		return false;
+	}
+
+	// when full, the oldest sample is where the next one would go
+	uint32_t index = inTrigger->historyNext;
+	for(uint32_t i = 0; i < pre; i++)
+	{
+		pingpong_push(inOut, inTrigger->history[index]);
+		index = (index + 1 == pre) ? 0 : index + 1;
+	}
+	inTrigger->waiting = 0;
+	inTrigger->postLeft = (uint32_t)inOut->blockSize - pre;
+	return trigger_push(inTrigger, inOut, inSample);
+}
@@ -16,34 +16,33 @@
 
 #include "uart.h"
 #include "handle_led.h"
-#include "circular_buffer.h"
+#include "spsc_ring.h"
+#include "ring_notify.h"
 #include <stddef.h>
 
 /**
- * How many characters we want to initially request for the circular buffer
+ * How many characters each ring holds. Must be a power of two.
  */
-#define UART_CAPACITY 100
+#define UART_CAPACITY 128
 
 /**
- * Transmit circular buffer
+ * Transmit ring. uart_echo produces, the ISR consumes.
  */
-static cbuf_handle_t sTxBuffer = NULL;
+static spsc_ring_u8_t sTxRing;
+static uint8_t sTxStorage[UART_CAPACITY];
 
 /**
- * Receive circular buffer
+ * Receive ring. The ISR produces and wakes a reader sleeping in
+ * uart_getchar_wait, which consumes.
  */
-static cbuf_handle_t sRxBuffer = NULL;
+static ring_notify_u8_t sRxRing;
+static uint8_t sRxStorage[UART_CAPACITY];
 
 /**
  * Enable interrupt macro
  */
 #define ENABLE_IRQ NVIC_EnableIRQ(UART0_IRQn);
 
-/**
- * Disable interrupt macro
- */
-#define DISABLE_IRQ NVIC_DisableIRQ(UART0_IRQn);
-
 void uart_init(int64_t baud_rate)
 {
 	 set_led(1, BLUE);
@@ -94,8 +93,10 @@ void uart_init(int64_t baud_rate)
 
 #if USE_UART_INTERRUPTS
 	// Enable interrupts. Listing 8.11 on p. 234
-	sTxBuffer = circular_buf_init(UART_CAPACITY);
-	sRxBuffer = circular_buf_init(UART_CAPACITY);
+	spsc_ring_u8_init(&sTxRing, sTxStorage, UART_CAPACITY);
+	ring_notify_u8_init(&sRxRing, sRxStorage, UART_CAPACITY, 0);
+	RING_STATS_REGISTER(&sTxRing, "UART TX");
+	RING_STATS_REGISTER(&sRxRing.ring, "UART RX");
 
 	NVIC_SetPriority(UART0_IRQn, 2); // 0, 1, 2, or 3
 	NVIC_ClearPendingIRQ(UART0_IRQn);
@@ -164,34 +165,59 @@ void uart_put_string(const char* str) {
 	}
 }
 
-bool uart_echo(uint8_t* outChar)
+bool uart_getchar_wait(uint8_t* outChar, uint32_t inTimeoutTicks)
 {
 #if USE_UART_INTERRUPTS
-	if(circular_buf_pop(sRxBuffer, outChar) == buff_err_success)
+	return ring_notify_u8_pop(&sRxRing, outChar, inTimeoutTicks) == buff_err_success;
+#else
+	// no receive interrupt to wake us, so check once per tick
+	while(!uart_getchar_present())
 	{
-		circular_buf_push_resize(&sTxBuffer, *outChar);
-		UART0->C2 |= UART0_C2_TIE_MASK;
-		return true;
+		if(!inTimeoutTicks)
+		{
+			return false;
+		}
+		if(inTimeoutTicks != portMAX_DELAY)
+		{
+			inTimeoutTicks--;
+		}
+		vTaskDelay(1);
 	}
-#else
-	uint8_t ch;
+	return uart_getchar(outChar);
+#endif
+}
 
-	if(uart_getchar(&ch))
+bool uart_echo_wait(uint8_t* outChar, uint32_t inTimeoutTicks)
+{
+	if(!uart_getchar_wait(outChar, inTimeoutTicks))
 	{
-		*outChar = ch;
-		uart_putchar(ch);
-		return true;
+		return false;
 	}
-
+#if USE_UART_INTERRUPTS
+	// the ISR drains the ring while the transmitter interrupt is on, so
+	// when it is full sleep a tick rather than spin and starve other tasks
+	while(spsc_ring_u8_push(&sTxRing, *outChar) == buff_err_full)
+	{
+		UART0->C2 |= UART0_C2_TIE_MASK;
+		vTaskDelay(1);
+	}
+	UART0->C2 |= UART0_C2_TIE_MASK;
+#else
+	uart_putchar(*outChar);
 #endif
-	return false;
+	return true;
+}
+
+bool uart_echo(uint8_t* outChar)
+{
+	return uart_echo_wait(outChar, 0);
 }
 
 // UART0 IRQ Handler. Listing 8.12 on p. 235
+// The rings are lock-free, so the interrupt does not need to be masked here.
 void UART0_IRQHandler(void) {
-	DISABLE_IRQ
-
 	uint8_t ch;
+	BaseType_t higherPriorityTaskWoken = pdFALSE;
 
 	// error handling
 	if (UART0->S1 & (UART_S1_OR_MASK |UART_S1_NF_MASK |
@@ -211,14 +237,10 @@ void UART0_IRQHandler(void) {
 	{
 
 		ch = UART0->D;
-		if (!circular_buf_full(sRxBuffer))
-		{
-			circular_buf_push_resize(&sRxBuffer, ch);
-		}
-		else
+		if (ring_notify_u8_push_from_isr(&sRxRing, ch, &higherPriorityTaskWoken) != buff_err_success)
 		{
 			// error - queue full.
-			// discard character
+			// discard character, counted as rejected in the ring stats
 		}
 
 		 set_led(1, BLUE);
@@ -229,13 +251,10 @@ void UART0_IRQHandler(void) {
 			(UART0->S1 & UART0_S1_TDRE_MASK) )
 	{
 		// can send another character
-		if (!circular_buf_empty(sTxBuffer))
+		uint8_t outCh;
+		if (spsc_ring_u8_pop(&sTxRing, &outCh) == buff_err_success)
 		{
-			uint32_t outCh = -1;
-			if(circular_buf_pop(sTxBuffer, &outCh) == buff_err_success)
-			{
-			  UART0->D = outCh;
-			}
+			UART0->D = outCh;
 		}
 		else
 		{
@@ -245,7 +264,8 @@ void UART0_IRQHandler(void) {
 		 set_led(1, GREEN);
 	}
 
-	ENABLE_IRQ
+	// a reader woken in uart_getchar_wait runs as soon as we return
+	portYIELD_FROM_ISR(higherPriorityTaskWoken);
 }
 
 
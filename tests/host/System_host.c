@@ -0,0 +1,49 @@
+/*
+ * @file System_host.c
+ * @brief Project 6
+ *
+ * @details uCUnit system hooks for running the unit tests on the PC.
+ *          The on-board hooks live in uCUnit/System.c and write over UART.
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "System.h"
+
+void System_exit(int val)
+{
+	exit(val);
+}
+
+void System_Init(void)
+{
+}
+
+void System_Shutdown(void)
+{
+	System_exit(0);
+}
+
+void System_Recover(void)
+{
+	System_exit(1);
+}
+
+void System_Safestate(void)
+{
+	System_exit(1);
+}
+
+void System_WriteString(char * msg)
+{
+	fputs(msg, stdout);
+}
+
+void System_WriteInt(int n)
+{
+	printf("%d", n);
+}
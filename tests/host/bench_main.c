@@ -0,0 +1,1080 @@
+/*
+ * @file bench_main.c
+ * @brief Project 6
+ *
+ * @details Micro benchmarks for the portable modules, run on the PC.
+ *
+ *          Build and run from the repo root:
+ *          gcc -std=gnu99 -Wall -O2 -DNDEBUG -iquote include -iquote CMSIS \
+ *              -DFILTER_CHAIN_DC_BLOCK=1 -DFILTER_CHAIN_BIQUAD_Q15=1 \
+ *              -DFILTER_CHAIN_BIQUAD_Q31=1 -DFILTER_CHAIN_FIR=1 \
+ *              tests/host/bench_main.c tests/host/board_host.c \
+ *              source/circular_buffer.c source/spsc_ring.c source/logger.c \
+ *              source/sine.c source/stream_stats.c source/adc_stats.c \
+ *              source/isqrt.c source/dsp_stats.c source/arm_math_ref.c \
+ *              source/sliding_stats.c source/running_median.c source/fft.c \
+ *              source/goertzel.c source/adc_quality.c source/dc_blocker.c \
+ *              source/decimator.c source/pingpong.c source/trigger.c \
+ *              source/histogram.c source/filter_chain.c \
+ *              -iquote tests/host/freertos tests/host/freertos_host.c \
+ *              tests/host/heap_host.c -lm -o bench_host && ./bench_host bench.csv
+ *
+ *          Every benchmark is run once to warm up and then BENCH_REPETITIONS
+ *          times. The table shows the median and the fastest run; the median
+ *          is what to compare between builds. If a file name is given, the
+ *          same results are written to it as CSV, one row per benchmark.
+ *
+ *          Add -DCIRCULAR_BUF_CHECKS=1 to measure with handle validation on.
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include "circular_buffer.h"
+#include "spsc_ring.h"
+#include "logger.h"
+#include "sine.h"
+#include "stream_stats.h"
+#include "adc_stats.h"
+#include "isqrt.h"
+#include "dsp_stats.h"
+#include "sliding_stats.h"
+#include "running_median.h"
+#include "fft.h"
+#include "goertzel.h"
+#include "adc_quality.h"
+#include "filter_chain.h"
+#include "decimator.h"
+#include "pingpong.h"
+#include "trigger.h"
+#include "histogram.h"
+#include "FreeRTOS.h"
+#include <math.h>
+
+/**
+ * Operations timed per measurement.
+ */
+#define BENCH_ITERATIONS 1000000
+
+/**
+ * Most buffers kept alive at once for the handle scaling benchmark.
+ */
+#define BENCH_MAX_LIVE 64
+
+/**
+ * Timed runs per benchmark, after one warm-up run.
+ */
+#define BENCH_REPETITIONS 7
+
+/**
+ * Keeps the optimizer from discarding benchmark results.
+ */
+static volatile uint32_t sSink;
+
+/**
+ * CSV output, or NULL.
+ */
+static FILE* sCsv = NULL;
+
+/**
+ * One run of a benchmark. Returns ns per operation.
+ */
+typedef double (*bench_fn)(size_t inParam);
+
+/**
+ * Monotonic time in nanoseconds.
+ */
+static uint64_t now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * qsort comparison for run times.
+ */
+static int compare_doubles(const void* a, const void* b)
+{
+	double lhs = *(const double*)a;
+	double rhs = *(const double*)b;
+	return (lhs > rhs) - (lhs < rhs);
+}
+
+/**
+ * Param column of a benchmark with no size of its own to report.
+ */
+#define BENCH_NO_PARAM SIZE_MAX
+
+/**
+ * Run a benchmark BENCH_REPETITIONS times and report the median and fastest run.
+ * inVariant is passed to inFn and picks what is measured; inParam is the
+ * size reported in the group's param column, or BENCH_NO_PARAM.
+ */
+static void bench_variant(const char* inName, bench_fn inFn, size_t inVariant, size_t inParam)
+{
+	double runs[BENCH_REPETITIONS];
+	inFn(inVariant);
+	for(size_t r = 0; r < BENCH_REPETITIONS; r++)
+	{
+		runs[r] = inFn(inVariant);
+	}
+	qsort(runs, BENCH_REPETITIONS, sizeof(runs[0]), compare_doubles);
+
+	double median = runs[BENCH_REPETITIONS / 2];
+	double fastest = runs[0];
+	double spread = 100.0 * (runs[BENCH_REPETITIONS - 1] - fastest) / median;
+	char param[24] = "-";
+	if(inParam != BENCH_NO_PARAM)
+	{
+		snprintf(param, sizeof(param), "%zu", inParam);
+	}
+	printf("%-24s %8s %10.2f %10.2f %12.0f %7.1f%%\n",
+			inName, param, median, fastest, 1e9 / median, spread);
+	if(sCsv)
+	{
+		fprintf(sCsv, "%s,%s,%.3f,%.3f,%.0f,%.2f\n",
+				inName, inParam == BENCH_NO_PARAM ? "" : param, median, fastest, 1e9 / median, spread);
+	}
+}
+
+/**
+ * Run a benchmark whose argument is the size in the param column.
+ */
+static void bench(const char* inName, bench_fn inFn, size_t inParam)
+{
+	bench_variant(inName, inFn, inParam, inParam);
+}
+
+/**
+ * Print a group heading and the table columns.
+ */
+static void bench_group(const char* inTitle, const char* inParamName)
+{
+	printf("\n%s\n", inTitle);
+	printf("%-24s %8s %10s %10s %12s %8s\n",
+			"benchmark", inParamName, "ns/op", "best", "ops/s", "spread");
+}
+
+/**
+ * Elements moved per run by the benchmarks that fill and drain a buffer.
+ */
+#define BENCH_ELEMENTS (1u << 22)
+
+/**
+ * Push into an empty buffer of inCapacity until full, then reset it.
+ * Only the pushes are timed.
+ */
+static double bench_cbuf_push(size_t inCapacity)
+{
+	cbuf_handle_t buf = circular_buf_init(inCapacity);
+	size_t rounds = BENCH_ELEMENTS / inCapacity;
+	uint64_t elapsed = 0;
+	for(size_t r = 0; r < rounds; r++)
+	{
+		uint64_t start = now_ns();
+		for(size_t i = 0; i < inCapacity; i++)
+		{
+			circular_buf_push(buf, i);
+		}
+		elapsed += now_ns() - start;
+		circular_buf_reset(buf);
+	}
+	circular_buf_free(buf);
+	return (double)elapsed / (double)(rounds * inCapacity);
+}
+
+/**
+ * Pop a full buffer of inCapacity until empty. Only the pops are timed.
+ */
+static double bench_cbuf_pop(size_t inCapacity)
+{
+	cbuf_handle_t buf = circular_buf_init(inCapacity);
+	size_t rounds = BENCH_ELEMENTS / inCapacity;
+	uint64_t elapsed = 0;
+	uint32_t out = 0;
+	for(size_t r = 0; r < rounds; r++)
+	{
+		for(size_t i = 0; i < inCapacity; i++)
+		{
+			circular_buf_push(buf, i);
+		}
+		uint64_t start = now_ns();
+		for(size_t i = 0; i < inCapacity; i++)
+		{
+			circular_buf_pop(buf, &out);
+		}
+		elapsed += now_ns() - start;
+	}
+	sSink = out;
+	circular_buf_free(buf);
+	return (double)elapsed / (double)(rounds * inCapacity);
+}
+
+/**
+ * Time a push/pop pair on the newest of inLive buffers.
+ * The newest buffer was the last node of the old ownership list, so this was
+ * the worst case for validation when it scanned the list.
+ */
+static double bench_cbuf_live(size_t inLive)
+{
+	cbuf_handle_t bufs[BENCH_MAX_LIVE];
+	for(size_t i = 0; i < inLive; i++)
+	{
+		bufs[i] = circular_buf_init(16);
+	}
+
+	cbuf_handle_t buf = bufs[inLive - 1];
+	uint32_t out = 0;
+	uint64_t start = now_ns();
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		circular_buf_push(buf, i);
+		circular_buf_pop(buf, &out);
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = out;
+
+	for(size_t i = 0; i < inLive; i++)
+	{
+		circular_buf_free(bufs[i]);
+	}
+	return (double)elapsed / (2.0 * BENCH_ITERATIONS);
+}
+
+/**
+ * Fill and drain a buffer of inCapacity, one element per call or with
+ * push_n/pop_n. Returns ns per element moved in and out.
+ */
+static double bench_fill_drain(size_t inCapacity, bool inBulk)
+{
+	cbuf_handle_t buf = circular_buf_init(inCapacity);
+	uint32_t* scratch = (uint32_t*)malloc(sizeof(uint32_t) * inCapacity);
+	for(size_t i = 0; i < inCapacity; i++)
+	{
+		scratch[i] = i;
+	}
+
+	// offset the indices so every fill and drain crosses the wrap
+	uint32_t out = 0;
+	for(size_t i = 0; i < inCapacity / 2; i++)
+	{
+		circular_buf_push(buf, 0);
+		circular_buf_pop(buf, &out);
+	}
+
+	size_t rounds = BENCH_ELEMENTS / inCapacity;
+	uint64_t start = now_ns();
+	for(size_t r = 0; r < rounds; r++)
+	{
+		if(inBulk)
+		{
+			circular_buf_push_n(buf, scratch, inCapacity, NULL);
+			circular_buf_pop_n(buf, scratch, inCapacity, NULL);
+		}
+		else
+		{
+			for(size_t i = 0; i < inCapacity; i++)
+			{
+				circular_buf_push(buf, scratch[i]);
+			}
+			for(size_t i = 0; i < inCapacity; i++)
+			{
+				circular_buf_pop(buf, &scratch[i]);
+			}
+		}
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = scratch[0];
+
+	free(scratch);
+	circular_buf_free(buf);
+	return (double)elapsed / (double)(rounds * inCapacity);
+}
+
+static double bench_cbuf_fill_drain(size_t inCapacity)
+{
+	return bench_fill_drain(inCapacity, false);
+}
+
+static double bench_cbuf_fill_drain_n(size_t inCapacity)
+{
+	return bench_fill_drain(inCapacity, true);
+}
+
+/**
+ * Resizes timed per run of bench_cbuf_resize.
+ */
+#define BENCH_RESIZES 20000
+
+/**
+ * Resize a half full buffer back and forth between inCapacity and twice that.
+ * Returns ns per resize, including the copy of the contents.
+ */
+static double bench_cbuf_resize(size_t inCapacity)
+{
+	cbuf_handle_t buf = circular_buf_init(inCapacity);
+	for(size_t i = 0; i < inCapacity / 2; i++)
+	{
+		circular_buf_push(buf, i);
+	}
+
+	uint64_t start = now_ns();
+	for(uint32_t i = 0; i < BENCH_RESIZES; i++)
+	{
+		circular_buf_resize(&buf, (i & 1) ? inCapacity : inCapacity * 2);
+	}
+	uint64_t elapsed = now_ns() - start;
+
+	circular_buf_free(buf);
+	return (double)elapsed / BENCH_RESIZES;
+}
+
+/**
+ * Grow a buffer from one element to inCount with push_resize.
+ * Returns ns per element, including the doubling resizes along the way.
+ */
+static double bench_cbuf_push_resize(size_t inCount)
+{
+	size_t rounds = BENCH_ELEMENTS / inCount;
+	uint64_t start = now_ns();
+	for(size_t r = 0; r < rounds; r++)
+	{
+		cbuf_handle_t buf = circular_buf_init(1);
+		for(size_t i = 0; i < inCount; i++)
+		{
+			circular_buf_push_resize(&buf, i);
+		}
+		circular_buf_free(buf);
+	}
+	uint64_t elapsed = now_ns() - start;
+	return (double)elapsed / (double)(rounds * inCount);
+}
+
+/**
+ * Time push+pop pairs through an SPSC ring of the given element width and
+ * capacity. Returns ns per operation.
+ */
+#define BENCH_SPSC_WIDTH(name, type)                                   \
+static double bench_##name(size_t inCapacity)                          \
+{                                                                      \
+	type * storage = (type *)malloc(sizeof(type) * inCapacity);        \
+	name##_t ring;                                                     \
+	type out = 0;                                                      \
+	name##_init(&ring, storage, inCapacity);                           \
+	uint64_t start = now_ns();                                         \
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)                     \
+	{                                                                  \
+		name##_push(&ring, (type)i);                                   \
+		name##_pop(&ring, &out);                                       \
+	}                                                                  \
+	uint64_t elapsed = now_ns() - start;                               \
+	sSink = out;                                                       \
+	free(storage);                                                     \
+	return (double)elapsed / (2.0 * BENCH_ITERATIONS);                 \
+}
+
+BENCH_SPSC_WIDTH(spsc_ring_u8, uint8_t)
+BENCH_SPSC_WIDTH(spsc_ring_u16, uint16_t)
+BENCH_SPSC_WIDTH(spsc_ring, uint32_t)
+
+/**
+ * Time sine table lookups, as done once per DAC update.
+ */
+static double bench_sine_sample(size_t inUnused)
+{
+	uint32_t sum = 0;
+	uint64_t start = now_ns();
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		sum += get_next_sine_sample();
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = sum;
+	return (double)elapsed / BENCH_ITERATIONS;
+}
+
+/**
+ * Time reducing a block of ADC codes into a stats window, per sample or
+ * with the block call. Returns ns per sample.
+ */
+static double bench_stream_stats(size_t inBlock, bool inPerSample)
+{
+	uint16_t samples[256];
+	stream_stats_t stats;
+	for(size_t i = 0; i < inBlock; i++)
+	{
+		samples[i] = (uint16_t)((i * 2654435761u) >> 20);
+	}
+
+	size_t rounds = BENCH_ITERATIONS / inBlock;
+	uint64_t start = now_ns();
+	for(size_t r = 0; r < rounds; r++)
+	{
+		stream_stats_reset(&stats);
+		if(inPerSample)
+		{
+			for(size_t i = 0; i < inBlock; i++)
+			{
+				stream_stats_add(&stats, samples[i]);
+			}
+		}
+		else
+		{
+			stream_stats_add_block_u16(&stats, samples, inBlock);
+		}
+		sSink = (uint32_t)stats.sumSquares;
+	}
+	uint64_t elapsed = now_ns() - start;
+	return (double)elapsed / (double)(rounds * inBlock);
+}
+
+static double bench_stream_stats_add(size_t inBlock)
+{
+	return bench_stream_stats(inBlock, true);
+}
+
+static double bench_stream_stats_block(size_t inBlock)
+{
+	return bench_stream_stats(inBlock, false);
+}
+
+/**
+ * Time the per-block histogram as dsp_callback keeps it: reset, add a
+ * block of inBlock codes, and fold it into a lifetime histogram.
+ * Returns ns per sample.
+ */
+static double bench_histogram(size_t inBlock)
+{
+	uint16_t* samples = (uint16_t*)malloc(sizeof(uint16_t) * inBlock);
+	for(size_t i = 0; i < inBlock; i++)
+	{
+		samples[i] = (uint16_t)((i * 2654435761u) >> 20);
+	}
+	static histogram_t block, lifetime;
+	histogram_reset(&lifetime);
+	uint64_t start = now_ns();
+	for(uint32_t r = 0; r < BENCH_ITERATIONS / inBlock; r++)
+	{
+		histogram_reset(&block);
+		histogram_add_block_u16(&block, samples, (uint32_t)inBlock);
+		histogram_merge(&lifetime, &block);
+	}
+	uint64_t elapsed = now_ns() - start;
+	uint16_t p99 = 0;
+	histogram_percentile(&lifetime, 9900, &p99);
+	sSink = p99;
+	free(samples);
+	return (double)elapsed / (BENCH_ITERATIONS / inBlock * inBlock);
+}
+
+/**
+ * Time converting a 64 sample block of codes to millivolts, either as a
+ * float multiply per sample or through adc_block_to_mv. Returns ns per sample.
+ */
+static double bench_code_to_mv(size_t inFixed)
+{
+	uint16_t samples[64];
+	uint16_t mv[64];
+	for(size_t i = 0; i < 64; i++)
+	{
+		samples[i] = (uint16_t)((i * 2654435761u) >> 20);
+	}
+	uint64_t start = now_ns();
+	for(uint32_t r = 0; r < BENCH_ITERATIONS / 64; r++)
+	{
+		if(inFixed)
+		{
+			adc_block_to_mv(samples, mv, 64);
+		}
+		else
+		{
+			for(size_t i = 0; i < 64; i++)
+			{
+				mv[i] = (uint16_t)(samples[i] * (3300.0f / 4096.0f) + 0.5f);
+			}
+		}
+		sSink = mv[r & 63];
+		// keep the samples live so the loop is not hoisted
+		samples[r & 63] ^= 1;
+	}
+	uint64_t elapsed = now_ns() - start;
+	return (double)elapsed / BENCH_ITERATIONS;
+}
+
+/**
+ * Time one dsp_callback block reduction and report, either the way it used
+ * to be done (each sample converted to float volts) or on raw codes with an
+ * integer millivolt report. Returns ns per block.
+ */
+static double bench_block_report(size_t inFixed)
+{
+	uint16_t samples[64];
+	for(size_t i = 0; i < 64; i++)
+	{
+		samples[i] = (uint16_t)((i * 2654435761u) >> 20);
+	}
+
+	uint64_t start = now_ns();
+	for(uint32_t r = 0; r < BENCH_ITERATIONS / 64; r++)
+	{
+		if(inFixed)
+		{
+			stream_stats_t stats;
+			adc_stats_report_t report;
+			stream_stats_reset(&stats);
+			stream_stats_add_block_u16(&stats, samples, 64);
+			adc_stats_report(&stats, &report);
+			sSink = report.varianceMv2;
+		}
+		else
+		{
+			float voltages[64];
+			float minV = 1e9f, maxV = 0, sum = 0, varianceSum = 0, mean = 0;
+			for(size_t i = 0; i < 64; i++)
+			{
+				float voltage = (float)(samples[i] * (3.300 / 4096.0));
+				minV = voltage < minV ? voltage : minV;
+				maxV = voltage > maxV ? voltage : maxV;
+				sum += voltage;
+				mean = sum / (float)(i + 1);
+				voltages[i] = voltage;
+			}
+			for(size_t i = 0; i < 64; i++)
+			{
+				varianceSum += (voltages[i] - mean) * (voltages[i] - mean);
+			}
+			sSink = (uint32_t)(varianceSum + minV + maxV);
+		}
+		// keep the samples live so the loop is not hoisted
+		samples[r & 63] ^= 1;
+	}
+	uint64_t elapsed = now_ns() - start;
+	return (double)elapsed / (BENCH_ITERATIONS / 64);
+}
+
+/**
+ * Time a 64 sample block of ADC codes through the CMSIS-DSP kernel path,
+ * to compare with block_report_fixed. Returns ns per block.
+ */
+static double bench_block_kernels(size_t inUnused)
+{
+	uint16_t samples[64];
+	dsp_block_stats_t stats;
+	uint64_t elapsed = 0;
+	for(uint32_t r = 0; r < BENCH_ITERATIONS / 64; r++)
+	{
+		// the kernels scale the block in place, so refill it untimed
+		for(size_t i = 0; i < 64; i++)
+		{
+			samples[i] = (uint16_t)(((i + r) * 2654435761u) >> 20);
+		}
+		uint64_t start = now_ns();
+		dsp_block_stats_q15((q15_t*)samples, 64, DSP_STATS_ADC_HEADROOM, &stats);
+		elapsed += now_ns() - start;
+		sSink = stats.stdDev;
+	}
+	return (double)elapsed / (BENCH_ITERATIONS / 64);
+}
+
+/**
+ * Time pushing samples through a sliding window of inSize.
+ * Returns ns per sample, including the min/max deque upkeep.
+ */
+static double bench_sliding_stats(size_t inSize)
+{
+	uint16_t* storage = (uint16_t*)malloc(sizeof(uint16_t) * SLIDING_STATS_STORAGE(inSize));
+	sliding_stats_t window;
+	sliding_stats_init(&window, storage, inSize);
+	uint32_t value = 1;
+	uint64_t start = now_ns();
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		value = value * 1103515245u + 12345u;
+		sliding_stats_push(&window, (uint16_t)(value >> 20));
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = sliding_stats_max(&window) + window.sum;
+	free(storage);
+	return (double)elapsed / BENCH_ITERATIONS;
+}
+
+/**
+ * Time pushing samples through a running median of inSize.
+ * Returns ns per sample.
+ */
+static double bench_running_median(size_t inSize)
+{
+	uint16_t* storage = (uint16_t*)malloc(sizeof(uint16_t) * RUNNING_MEDIAN_STORAGE(inSize));
+	running_median_t median;
+	running_median_init(&median, storage, inSize);
+	uint32_t value = 1;
+	uint32_t sum = 0;
+	uint64_t start = now_ns();
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		value = value * 1103515245u + 12345u;
+		sum += running_median_push(&median, (uint16_t)(value >> 20));
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = sum;
+	free(storage);
+	return (double)elapsed / BENCH_ITERATIONS;
+}
+
+/**
+ * Time one block through the transform alone (0) or the whole spectrum
+ * report (1), including windowing and THD. Returns ns per block.
+ */
+static double bench_fft(size_t inAnalyze)
+{
+	static q15_t work[FFT_WORK_LENGTH];
+	uint16_t samples[FFT_SIZE];
+	fft_analysis_t analysis;
+	for(size_t i = 0; i < FFT_SIZE; i++)
+	{
+		samples[i] = (uint16_t)(2048 + 1200 * sin(2.0 * M_PI * 5.3 * i / FFT_SIZE));
+	}
+	uint64_t elapsed = 0;
+	for(uint32_t r = 0; r < BENCH_ITERATIONS / FFT_SIZE; r++)
+	{
+		// the transform works in place, so refill it untimed
+		for(size_t i = 0; i < FFT_SIZE; i++)
+		{
+			work[2 * i] = (q15_t)((samples[i] - 2048) * 8);
+			work[2 * i + 1] = 0;
+		}
+		uint64_t start = now_ns();
+		if(inAnalyze)
+		{
+			fft_analyze_block_u16(samples, FFT_SIZE, 10000, work, &analysis);
+			sSink = analysis.thdPpm;
+		}
+		else
+		{
+			fft_q15(work);
+			sSink = work[10];
+		}
+		elapsed += now_ns() - start;
+	}
+	return (double)elapsed / (BENCH_ITERATIONS / FFT_SIZE);
+}
+
+/**
+ * Time the stimulus fundamental and inTargets - 1 of its harmonics over
+ * one period of the sine, as dsp_callback does. Returns ns per block.
+ */
+static double bench_goertzel(size_t inTargets)
+{
+	static const goertzel_target_t targets[] = {
+		GOERTZEL_TARGET(1, 50, 50),
+		GOERTZEL_TARGET(2, 50, 50),
+		GOERTZEL_TARGET(3, 50, 50),
+	};
+	uint16_t samples[64];
+	goertzel_result_t results[3];
+	for(size_t i = 0; i < 64; i++)
+	{
+		samples[i] = (uint16_t)(2048 + 1200 * sin(2.0 * M_PI * i / 50));
+	}
+	uint64_t start = now_ns();
+	for(uint32_t r = 0; r < BENCH_ITERATIONS / 64; r++)
+	{
+		// keep the samples live so the loop is not hoisted
+		samples[r & 63] ^= 1;
+		goertzel_block_u16(samples, 64, 2048, targets, inTargets, results);
+		sSink = results[0].amplitude;
+	}
+	uint64_t elapsed = now_ns() - start;
+	return (double)elapsed / (BENCH_ITERATIONS / 64);
+}
+
+/**
+ * Time the closed-loop quality fit on a 64 sample block of the stimulus.
+ * Returns ns per block.
+ */
+static double bench_adc_quality(size_t inUnused)
+{
+	uint16_t samples[64];
+	adc_quality_t quality;
+	for(size_t i = 0; i < 64; i++)
+	{
+		samples[i] = (uint16_t)(2482 + 1241 * sin(2.0 * M_PI * i / NUM_SINE_SAMPLES));
+	}
+	uint64_t start = now_ns();
+	for(uint32_t r = 0; r < BENCH_ITERATIONS / 64; r++)
+	{
+		// keep the samples live so the loop is not hoisted
+		samples[r & 63] ^= 1;
+		adc_quality_measure(samples, 64, &quality);
+		sSink = quality.sinadCentiDb;
+	}
+	uint64_t elapsed = now_ns() - start;
+	return (double)elapsed / (BENCH_ITERATIONS / 64);
+}
+
+/**
+ * Time the filter chain as shipped, every stage built, on 64 sample blocks
+ * of the stimulus. On the target, filter_chain_log splits this by stage.
+ * Returns ns per sample.
+ */
+static double bench_filter_chain(size_t inBlock)
+{
+	q15_t source[FILTER_CHAIN_MAX_BLOCK];
+	q15_t samples[FILTER_CHAIN_MAX_BLOCK];
+	for(size_t i = 0; i < inBlock; i++)
+	{
+		source[i] = (q15_t)(2482 + 1241 * sin(2.0 * M_PI * i / NUM_SINE_SAMPLES));
+	}
+	filter_chain_init();
+	uint64_t elapsed = 0;
+	for(uint32_t r = 0; r < BENCH_ITERATIONS / inBlock; r++)
+	{
+		// a fresh block each time, as the ADC hands over, outside the timing
+		memcpy(samples, source, inBlock * sizeof(q15_t));
+		uint64_t start = now_ns();
+		filter_chain_process(samples, (uint32_t)inBlock);
+		elapsed += now_ns() - start;
+		sSink = samples[r % inBlock];
+	}
+	return (double)elapsed / (BENCH_ITERATIONS / inBlock * inBlock);
+}
+
+/**
+ * Time the oversampling front end at inRatio conversions per output.
+ * Returns ns per conversion, so the cost of the faster ADC timer is that
+ * times the ratio per reported sample.
+ */
+static double bench_decimator(size_t inRatio)
+{
+	decimator_t decimator;
+	decimator_init(&decimator, (uint32_t)inRatio);
+	uint16_t out = 0;
+	uint32_t outputs = 0;
+	uint64_t start = now_ns();
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		outputs += decimator_push(&decimator, (uint16_t)(2048 + (i & 255)), &out);
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = out + outputs;
+	return (double)elapsed / BENCH_ITERATIONS;
+}
+
+/**
+ * Time the trigger in front of the ping-pong blocks, in mode inMode with a
+ * quarter block of history, on a sine of 50 samples per period. Captures
+ * are released at once. Returns ns per sample.
+ */
+static double bench_trigger(size_t inMode)
+{
+	uint16_t storage[2 * 64];
+	uint16_t history[16];
+	uint16_t stimulus[50];
+	for(uint32_t i = 0; i < 50; i++)
+	{
+		stimulus[i] = (uint16_t)lround(2482 + 1241 * sin(2.0 * M_PI * i / 50));
+	}
+	pingpong_t pp;
+	trigger_t trigger;
+	trigger_config_t config = { .mode = (trigger_mode)inMode, .level = 2482, .hysteresis = 62,
+		                        .low = 1117, .high = 3847, .preTrigger = 16 };
+	pingpong_init(&pp, storage, 64);
+	trigger_init(&trigger, &config, history, 64);
+	uint32_t captures = 0;
+	uint32_t phase = 0;
+	uint64_t start = now_ns();
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		if(trigger_push(&trigger, &pp, stimulus[phase]))
+		{
+			captures++;
+			pingpong_release(&pp);
+		}
+		phase = phase + 1 == 50 ? 0 : phase + 1;
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = captures;
+	return (double)elapsed / BENCH_ITERATIONS;
+}
+
+/**
+ * Blocks handed over per run of the handoff benchmarks.
+ */
+#define BENCH_HANDOFF_BLOCKS 20000
+
+/**
+ * Time the handoff of inBlock ADC samples to DSP as it was done before the
+ * ping-pong buffer: push each sample into the ADC circular buffer, copy the
+ * storage into the DSP buffer (memcpy stands in for the DMA transfer, which
+ * dma_transfer waited for), copy the bookkeeping across, reset the ADC
+ * buffer and pop the block on the DSP side. The DSP task that was created
+ * per block is left out, see bench_task_heap. Returns ns per block.
+ */
+static double bench_copy_handoff(size_t inBlock)
+{
+	cbuf_handle_t adc = circular_buf_init(inBlock);
+	cbuf_handle_t dsp = circular_buf_init(inBlock);
+	uint32_t sum = 0;
+	uint64_t start = now_ns();
+	for(uint32_t b = 0; b < BENCH_HANDOFF_BLOCKS; b++)
+	{
+		for(uint32_t i = 0; i < inBlock; i++)
+		{
+			circular_buf_push(adc, (b + i) & 0xFFFu);
+		}
+		memcpy(dsp->buffer, adc->buffer, inBlock * sizeof(uint32_t));
+		circular_buf_copy(adc, dsp);
+		circular_buf_reset(adc);
+
+		uint32_t data;
+		while(circular_buf_pop(dsp, &data) == buff_err_success)
+		{
+			sum += data;
+		}
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = sum;
+	circular_buf_free(adc);
+	circular_buf_free(dsp);
+	return (double)elapsed / BENCH_HANDOFF_BLOCKS;
+}
+
+/**
+ * Time the same handoff through the ping-pong buffer: push each sample, then
+ * acquire the block, read it in place and release it. Returns ns per block.
+ */
+static double bench_pingpong_handoff(size_t inBlock)
+{
+	uint16_t* storage = malloc(2 * inBlock * sizeof(uint16_t));
+	pingpong_t pp;
+	pingpong_init(&pp, storage, inBlock);
+	uint32_t sum = 0;
+	uint64_t start = now_ns();
+	for(uint32_t b = 0; b < BENCH_HANDOFF_BLOCKS; b++)
+	{
+		for(uint32_t i = 0; i < inBlock; i++)
+		{
+			pingpong_push(&pp, (uint16_t)((b + i) & 0xFFFu));
+		}
+
+		size_t count;
+		uint16_t* block = pingpong_acquire(&pp, &count);
+		for(size_t i = 0; i < count; i++)
+		{
+			sum += block[i];
+		}
+		pingpong_release(&pp);
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = sum;
+	free(storage);
+	return (double)elapsed / BENCH_HANDOFF_BLOCKS;
+}
+
+/**
+ * Time the heap traffic of the DSP task that used to be created per block:
+ * a stack of inStackWords from heap_4 and its release once the task had
+ * deleted itself. The TCB was a second, smaller allocation and is left out.
+ * The long-lived DSP task allocates nothing per block. Returns ns per block.
+ */
+static double bench_task_heap(size_t inStackWords)
+{
+	uint32_t failures = 0;
+	uint64_t start = now_ns();
+	for(uint32_t i = 0; i < BENCH_HANDOFF_BLOCKS; i++)
+	{
+		void* stack = pvPortMalloc(inStackWords * sizeof(StackType_t));
+		if(!stack)
+		{
+			failures++;
+		}
+		vPortFree(stack);
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = failures;
+	return (double)elapsed / BENCH_HANDOFF_BLOCKS;
+}
+
+/**
+ * Time square roots of values spread over 2^inBits: integer isqrt,
+ * or libm sqrt as dsp_callback used to call it. Returns ns per root.
+ */
+static double bench_sqrt(size_t inBits, bool inInteger)
+{
+	uint64_t mask = inBits >= 64 ? UINT64_MAX : (1ull << inBits) - 1;
+	uint64_t value = 0x9E3779B97F4A7C15ull;
+	uint32_t sum = 0;
+	uint64_t start = now_ns();
+	for(uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		value = value * 6364136223846793005ull + 1442695040888963407ull;
+		if(inInteger)
+		{
+			sum += inBits <= 32 ? isqrt32((uint32_t)(value & mask)) : isqrt64(value & mask);
+		}
+		else
+		{
+			sum += (uint32_t)sqrt((double)(value & mask));
+		}
+	}
+	uint64_t elapsed = now_ns() - start;
+	sSink = sum;
+	return (double)elapsed / BENCH_ITERATIONS;
+}
+
+static double bench_isqrt(size_t inBits)
+{
+	return bench_sqrt(inBits, true);
+}
+
+static double bench_libm_sqrt(size_t inBits)
+{
+	return bench_sqrt(inBits, false);
+}
+
+/**
+ * Log calls timed per run of the logger benchmarks.
+ */
+#define BENCH_LOG_CALLS 100000
+
+/**
+ * Time a log_string call with inArgs printf arguments, including the prefix
+ * and timestamp. UART output is counted, not sent, so this is formatting only.
+ */
+static double bench_log_string(size_t inArgs)
+{
+	uint64_t start = now_ns();
+	for(uint32_t i = 0; i < BENCH_LOG_CALLS; i++)
+	{
+		if(inArgs)
+		{
+			LOG_STRING_ARGS(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS,
+					"Min: %u, Max: %u, Avg: %u", i, i + 1, i + 2);
+		}
+		else
+		{
+			LOG_STRING(LOG_MODULE_TASKS, LOG_SEVERITY_STATUS, "Exiting app.");
+		}
+	}
+	uint64_t elapsed = now_ns() - start;
+	return (double)elapsed / BENCH_LOG_CALLS;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc > 1)
+	{
+		sCsv = fopen(argv[1], "w");
+		if(!sCsv)
+		{
+			perror(argv[1]);
+			return 1;
+		}
+		fprintf(sCsv, "benchmark,param,ns_per_op,best_ns_per_op,ops_per_sec,spread_pct\n");
+	}
+
+	printf("circular_buf checks %s, %d runs per benchmark\n",
+			CIRCULAR_BUF_CHECKS ? "on" : "off", BENCH_REPETITIONS);
+
+	bench_group("circular_buf, per element", "capacity");
+	bench("cbuf_push", bench_cbuf_push, 64);
+	bench("cbuf_pop", bench_cbuf_pop, 64);
+	for(size_t capacity = 64; capacity <= 65536; capacity *= 4)
+	{
+		bench("cbuf_fill_drain", bench_cbuf_fill_drain, capacity);
+		bench("cbuf_fill_drain_n", bench_cbuf_fill_drain_n, capacity);
+	}
+
+	bench_group("circular_buf push+pop vs live buffers", "live");
+	for(size_t live = 1; live <= BENCH_MAX_LIVE; live *= 2)
+	{
+		bench("cbuf_live", bench_cbuf_live, live);
+	}
+
+	bench_group("circular_buf growth", "elements");
+	bench("cbuf_resize", bench_cbuf_resize, 64);
+	bench("cbuf_resize", bench_cbuf_resize, 1024);
+	bench("cbuf_push_resize", bench_cbuf_push_resize, 64);
+	bench("cbuf_push_resize", bench_cbuf_push_resize, 4096);
+
+	bench_group("spsc ring push+pop by element width", "capacity");
+	bench("spsc_ring_u8", bench_spsc_ring_u8, 128);
+	bench("spsc_ring_u16", bench_spsc_ring_u16, 128);
+	bench("spsc_ring_u32", bench_spsc_ring, 128);
+
+	bench_group("block statistics, ns per sample", "block");
+	bench("stream_stats_add", bench_stream_stats_add, 64);
+	bench("stream_stats_block_u16", bench_stream_stats_block, 64);
+	bench_variant("code_to_mv_float", bench_code_to_mv, 0, 64);
+	bench_variant("adc_block_to_mv", bench_code_to_mv, 1, 64);
+	bench("histogram_block_merge", bench_histogram, 64);
+	bench("histogram_block_merge", bench_histogram, 1024);
+
+	bench_group("sliding windows, ns per sample", "window");
+	bench("sliding_stats_push", bench_sliding_stats, 16);
+	bench("sliding_stats_push", bench_sliding_stats, 1024);
+	bench("running_median_push", bench_running_median, 5);
+	bench("running_median_push", bench_running_median, 15);
+	bench("running_median_push", bench_running_median, 31);
+	bench("running_median_push", bench_running_median, 63);
+
+	bench_group("dsp block report, ns per block", "block");
+	bench_variant("block_report_float", bench_block_report, 0, 64);
+	bench_variant("block_report_fixed", bench_block_report, 1, 64);
+	bench_variant("block_report_kernels", bench_block_kernels, 0, 64);
+
+	bench_group("spectrum, ns per block", "block");
+	bench_variant("fft_q15", bench_fft, 0, FFT_SIZE);
+	bench_variant("fft_analyze_block_u16", bench_fft, 1, FFT_SIZE);
+	bench_variant("adc_quality_measure", bench_adc_quality, 0, 64);
+
+	bench_group("goertzel, ns per block", "targets");
+	bench("goertzel_block_u16", bench_goertzel, 1);
+	bench("goertzel_block_u16", bench_goertzel, 3);
+
+	bench_group("filter chain, ns per sample", "block");
+	bench("filter_chain_process", bench_filter_chain, 64);
+
+	bench_group("decimator, ns per conversion", "ratio");
+	bench("decimator_push", bench_decimator, 4);
+	bench("decimator_push", bench_decimator, 64);
+
+	bench_group("trigger, ns per sample", "block");
+	bench_variant("trigger_free_run", bench_trigger, trigger_mode_free_run, 64);
+	bench_variant("trigger_rising", bench_trigger, trigger_mode_rising, 64);
+	bench_variant("trigger_window", bench_trigger, trigger_mode_window, 64);
+
+	bench_group("block handoff, ns per block", "block");
+	bench("copy_handoff", bench_copy_handoff, 64);
+	bench("pingpong_handoff", bench_pingpong_handoff, 64);
+
+	bench_group("DSP task heap traffic, ns per block", "words");
+	bench("task_stack_alloc_free", bench_task_heap, configMINIMAL_STACK_SIZE + 512);
+
+	bench_group("square root", "bits");
+	bench("isqrt", bench_isqrt, 24);
+	bench("libm_sqrt", bench_libm_sqrt, 24);
+	bench("isqrt", bench_isqrt, 48);
+	bench("libm_sqrt", bench_libm_sqrt, 48);
+
+	bench_group("sine and logger", "args");
+	sine_init();
+	bench_variant("sine_sample", bench_sine_sample, 0, BENCH_NO_PARAM);
+	log_enable(LOG_SEVERITY_STATUS);
+	bench("log_string", bench_log_string, 0);
+	bench("log_string_args", bench_log_string, 3);
+	log_disable();
+
+	if(sCsv)
+	{
+		fclose(sCsv);
+	}
+	return 0;
+}
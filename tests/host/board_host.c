@@ -0,0 +1,54 @@
+/*
+ * @file board_host.c
+ * @brief Project 6
+ *
+ * @details Stand-ins for the board drivers used by the portable modules,
+ *          so source/logger.c, source/sine.c and source/filter_chain.c can
+ *          run on the PC. Output is counted rather than printed, and the
+ *          cycle counter counts nanoseconds.
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ */
+
+#include <string.h>
+#include <time.h>
+#include "handle_led.h"
+#include "time.h"
+#include "uart.h"
+#include "cycle_count.h"
+
+/**
+ * Characters "sent" over the UART.
+ */
+volatile size_t gHostUartBytes = 0;
+
+void uart_put_string(const char* inChar)
+{
+	gHostUartBytes += strlen(inChar);
+}
+
+void timestamp_now(timestamp_str* outTimestamp)
+{
+	strcpy(outTimestamp->hours, "00:");
+	strcpy(outTimestamp->mins, "00:");
+	strcpy(outTimestamp->secs, "00.");
+	strcpy(outTimestamp->tens, "0");
+}
+
+void set_led(uint8_t inValue, enum COLOR inColor)
+{
+}
+
+uint32_t cycle_count_now()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
+
+uint32_t cycle_count_to_us(uint32_t inCycles)
+{
+	return inCycles / 1000u;
+}
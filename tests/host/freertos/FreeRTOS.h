@@ -0,0 +1,52 @@
+/*
+ * @file FreeRTOS.h
+ * @brief Project 6
+ *
+ * @details Host stand-in for the FreeRTOS types used by the portable
+ *          modules, and the settings heap_4.c needs. See freertos_host.c
+ *          and heap_host.c.
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ */
+
+#ifndef FREERTOS_HOST_H
+#define FREERTOS_HOST_H
+
+// keeps the real header out when heap_4.c includes it, see heap_host.c
+#define INC_FREERTOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef long BaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS (pdTRUE)
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+
+/**
+ * Heap settings as in source/FreeRTOSConfig.h and the Cortex-M0 port.
+ */
+#define configTOTAL_HEAP_SIZE ((size_t)(10 * 1024))
+#define configMINIMAL_STACK_SIZE ((unsigned short)200)
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configAPPLICATION_ALLOCATED_HEAP 0
+#define configUSE_MALLOC_FAILED_HOOK 0
+#define portBYTE_ALIGNMENT 8
+#define portBYTE_ALIGNMENT_MASK (0x0007)
+#define configASSERT(x)
+#define mtCOVERAGE_TEST_MARKER()
+#define traceMALLOC(pvAddress, uiSize)
+#define traceFREE(pvAddress, uiSize)
+
+void* pvPortMalloc(size_t xWantedSize);
+void vPortFree(void* pv);
+size_t xPortGetFreeHeapSize(void);
+size_t xPortGetMinimumEverFreeHeapSize(void);
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * @file task.h
+ * @brief Project 6
+ *
+ * @details Host stand-in for the FreeRTOS task notification, time-out and
+ *          scheduler suspend calls, for one simulated task. See freertos_host.c.
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ */
+
+#ifndef TASK_HOST_H
+#define TASK_HOST_H
+
+// keeps the real header out when heap_4.c includes it, see heap_host.c
+#define INC_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+
+typedef struct xTIME_OUT {
+	TickType_t start;
+} TimeOut_t;
+
+/**
+ * Ticks since the simulation started.
+ */
+extern TickType_t gHostTicks;
+
+/**
+ * Called once per tick while the simulated task is blocked, so a test can
+ * play a producer or an unrelated notifier. NULL for none.
+ */
+extern void (*gHostBlockedTick)(TickType_t inNow);
+
+/**
+ * Notifications given to the simulated task, and its pending count.
+ */
+extern uint32_t gHostNotificationsGiven;
+extern uint32_t gHostNotifyValue;
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+void xTaskNotifyGive(TaskHandle_t inTask);
+void vTaskNotifyGiveFromISR(TaskHandle_t inTask, BaseType_t* outHigherPriorityTaskWoken);
+uint32_t ulTaskNotifyTake(BaseType_t inClearOnExit, TickType_t inTicksToWait);
+void vTaskSetTimeOutState(TimeOut_t* const outTimeOut);
+BaseType_t xTaskCheckForTimeOut(TimeOut_t* const inTimeOut, TickType_t* const ioTicksToWait);
+void vTaskSuspendAll(void);
+BaseType_t xTaskResumeAll(void);
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * @file freertos_host.c
+ * @brief Project 6
+ *
+ * @details Task notifications and time-outs for one simulated task, so
+ *          ring_notify can be tested on the PC. Blocking advances a tick
+ *          counter instead of sleeping, calling gHostBlockedTick on each
+ *          tick, and ends as soon as a notification is pending.
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ */
+
+#include <stddef.h>
+#include "task.h"
+
+TickType_t gHostTicks = 0;
+void (*gHostBlockedTick)(TickType_t inNow) = NULL;
+uint32_t gHostNotificationsGiven = 0;
+uint32_t gHostNotifyValue = 0;
+
+/**
+ * The one task there is.
+ */
+static int sHostTask;
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+	return &sHostTask;
+}
+
+void xTaskNotifyGive(TaskHandle_t inTask)
+{
+	if(inTask == &sHostTask)
+	{
+		gHostNotificationsGiven++;
+		gHostNotifyValue++;
+	}
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t inTask, BaseType_t* outHigherPriorityTaskWoken)
+{
+	xTaskNotifyGive(inTask);
+	*outHigherPriorityTaskWoken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t inClearOnExit, TickType_t inTicksToWait)
+{
+	TickType_t waited = 0;
+	while(!gHostNotifyValue && waited < inTicksToWait)
+	{
+		gHostTicks++;
+		waited++;
+		if(gHostBlockedTick)
+		{
+			gHostBlockedTick(gHostTicks);
+		}
+	}
+
+	uint32_t value = gHostNotifyValue;
+	if(value)
+	{
+		gHostNotifyValue = inClearOnExit ? 0 : value - 1;
+	}
+	return value;
+}
+
+void vTaskSetTimeOutState(TimeOut_t* const outTimeOut)
+{
+	outTimeOut->start = gHostTicks;
+}
+
+BaseType_t xTaskCheckForTimeOut(TimeOut_t* const inTimeOut, TickType_t* const ioTicksToWait)
+{
+	if(*ioTicksToWait == portMAX_DELAY)
+	{
+		return pdFALSE;
+	}
+	TickType_t elapsed = gHostTicks - inTimeOut->start;
+	if(elapsed >= *ioTicksToWait)
+	{
+		*ioTicksToWait = 0;
+		return pdTRUE;
+	}
+	*ioTicksToWait -= elapsed;
+	inTimeOut->start = gHostTicks;
+	return pdFALSE;
+}
+
+/**
+ * There is nothing to preempt the one task, so suspending is a no-op.
+ */
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+	return pdFALSE;
+}
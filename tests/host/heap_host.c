@@ -0,0 +1,18 @@
+/*
+ * @file heap_host.c
+ * @brief Project 6
+ *
+ * @details The firmware's heap_4 allocator built for the PC, so the cost of
+ *          heap traffic can be measured. heap_4.c includes the real FreeRTOS
+ *          headers from its own directory; the stand-ins are included first
+ *          and define their guards, so those are skipped.
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "../../freertos/heap_4.c"
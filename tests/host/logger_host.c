@@ -0,0 +1,25 @@
+/*
+ * @file logger_host.c
+ * @brief Project 6
+ *
+ * @details Logger for running the unit tests on the PC.
+ *          The on-board logger lives in source/logger.c and writes over UART.
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include "logger.h"
+
+void log_string(LogModule_t inModule, const char* inFuncName, LogSeverity_t inSeverity, const char* inString, ...)
+{
+	va_list args;
+	va_start(args, inString);
+	printf("%s: ", inFuncName);
+	vprintf(inString, args);
+	printf("\n");
+	va_end(args);
+}
@@ -0,0 +1,1998 @@
+/*
+ * @file test_main.c
+ * @brief Project 6
+ *
+ * @details Unit tests for the portable modules, run on the PC.
+ *          tests/main.c holds the on-board suite. Every filter chain
+ *          stage is built, so the shipped coefficients are tested.
+ *
+ *          Build and run from the repo root:
+ *          gcc -std=gnu99 -Wall -O2 -iquote include -iquote uCUnit -iquote CMSIS \
+ *              -iquote tests/host/freertos -DCIRCULAR_BUF_POOL_SIZE=4 \
+ *              -DFILTER_CHAIN_DC_BLOCK=1 -DFILTER_CHAIN_BIQUAD_Q15=1 \
+ *              -DFILTER_CHAIN_BIQUAD_Q31=1 -DFILTER_CHAIN_FIR=1 \
+ *              tests/host/test_main.c tests/host/System_host.c \
+ *              tests/host/logger_host.c tests/host/board_host.c \
+ *              tests/host/freertos_host.c source/ring_notify.c \
+ *              source/circular_buffer.c source/filter_chain.c \
+ *              source/spsc_ring.c source/pingpong.c source/ring_stats.c \
+ *              source/broadcast_ring.c source/stream_stats.c source/adc_stats.c \
+ *              source/isqrt.c source/dsp_stats.c source/arm_math_ref.c \
+ *              source/sliding_stats.c source/running_median.c source/fft.c \
+ *              source/goertzel.c source/adc_quality.c source/dc_blocker.c \
+ *              source/decimator.c source/trigger.c source/histogram.c \
+ *              -pthread -lm -o test_host && ./test_host
+ *
+ * @tools  PC Compiler: GNU gcc 8.3.0
+ *         PC Linker: GNU ld 2.32
+ *         PC Debugger: GNU gdb 8.2.91.20190405-git
+ */
+
+#include "uCUnit.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "circular_buffer.h"
+#include "spsc_ring.h"
+#include "pingpong.h"
+#include "broadcast_ring.h"
+#include "ring_notify.h"
+#include "stream_stats.h"
+#include "adc_stats.h"
+#include "isqrt.h"
+#include "dsp_stats.h"
+#include "sliding_stats.h"
+#include "running_median.h"
+#include "fft.h"
+#include "goertzel.h"
+#include "adc_quality.h"
+#include "dc_blocker.h"
+#include "filter_chain.h"
+#include "decimator.h"
+#include "trigger.h"
+#include "histogram.h"
+#include "sine.h"
+
+#define TEST_BUF_SIZE 16
+
+/**
+ * A struct-element ring, instantiated here the way a module would.
+ */
+typedef struct test_pair_t {
+	uint16_t code;
+	uint8_t channel;
+} test_pair_t;
+
+SPSC_RING_DECLARE(test_pair_ring, test_pair_t)
+SPSC_RING_DEFINE(test_pair_ring, test_pair_t)
+
+/**
+ * Elements passed through the SPSC ring by the stress test.
+ */
+#define SPSC_STRESS_COUNT 20000000u
+
+/**
+ * Ring and tallies shared by the SPSC stress test threads.
+ */
+static spsc_ring_t sStressRing;
+static uint32_t sStressStorage[256];
+static uint32_t sStressErrors = 0;
+
+/**
+ * Pushes 0..SPSC_STRESS_COUNT-1 in order, yielding while the ring is full.
+ */
+static void* spsc_stress_producer(void* cookie)
+{
+	for(uint32_t i = 0; i < SPSC_STRESS_COUNT; i++)
+	{
+		while(spsc_ring_push(&sStressRing, i) != buff_err_success)
+		{
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Pops everything and checks that it arrives exactly once and in order.
+ */
+static void* spsc_stress_consumer(void* cookie)
+{
+	uint32_t expected = 0;
+	while(expected < SPSC_STRESS_COUNT)
+	{
+		uint32_t data;
+		if(spsc_ring_pop(&sStressRing, &data) == buff_err_success)
+		{
+			if(data != expected)
+			{
+				sStressErrors++;
+				expected = data;
+			}
+			expected++;
+		}
+		else
+		{
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Samples passed through the broadcast ring by its stress test.
+ */
+#define BROADCAST_STRESS_COUNT 2000000u
+
+/**
+ * Ring and tallies shared by the broadcast stress test threads.
+ */
+static broadcast_ring_t sBroadcastRing;
+static uint16_t sBroadcastStorage[256];
+static uint32_t sBroadcastErrors[2] = {0, 0};
+
+/**
+ * Pushes a wrapping count, yielding while the slowest reader is full.
+ */
+static void* broadcast_stress_producer(void* cookie)
+{
+	for(uint32_t i = 0; i < BROADCAST_STRESS_COUNT; i++)
+	{
+		while(broadcast_ring_push(&sBroadcastRing, (uint16_t)i) != buff_err_success)
+		{
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Set by the overwrite stress producer once it has pushed everything.
+ */
+static volatile bool sBroadcastDone;
+
+/**
+ * Pushes a wrapping count as fast as it can, overwriting the readers.
+ */
+static void* broadcast_overwrite_producer(void* cookie)
+{
+	for(uint32_t i = 0; i < BROADCAST_STRESS_COUNT; i++)
+	{
+		broadcast_ring_push(&sBroadcastRing, (uint16_t)i);
+		if(!(i & 1023))
+		{
+			sched_yield();
+		}
+	}
+	__atomic_store_n(&sBroadcastDone, true, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+/**
+ * Reads as one reader while being lapped. A sample's value is its index,
+ * so every sample handed out must equal samples read plus samples lost.
+ */
+static void* broadcast_overwrite_consumer(void* cookie)
+{
+	size_t reader = (size_t)cookie;
+	uint32_t read = 0;
+	for(;;)
+	{
+		bool done = __atomic_load_n(&sBroadcastDone, __ATOMIC_ACQUIRE);
+		broadcast_span_t spans[2];
+		uint16_t copy[256];
+		uint16_t sample;
+		if(read & 1)
+		{
+			if(broadcast_ring_pop(&sBroadcastRing, reader, &sample) == buff_err_success)
+			{
+				sBroadcastErrors[reader] += (sample != (uint16_t)(read + broadcast_ring_lost(&sBroadcastRing, reader)));
+				read++;
+				continue;
+			}
+		}
+		else
+		{
+			size_t count = broadcast_ring_peek_read(&sBroadcastRing, reader, spans);
+			uint32_t first = read + broadcast_ring_lost(&sBroadcastRing, reader);
+			size_t n = 0;
+			for(size_t s = 0; s < 2; s++)
+			{
+				for(size_t i = 0; i < spans[s].count; i++)
+				{
+					copy[n++] = spans[s].data[i];
+				}
+			}
+			// only what survived the commit has to be right
+			if(count && broadcast_ring_commit_read(&sBroadcastRing, reader, count) == buff_err_success)
+			{
+				for(size_t i = 0; i < count; i++)
+				{
+					sBroadcastErrors[reader] += (copy[i] != (uint16_t)(first + i));
+				}
+				read += (uint32_t)count;
+				continue;
+			}
+			if(count)
+			{
+				continue;
+			}
+		}
+		if(done && !broadcast_ring_size(&sBroadcastRing, reader))
+		{
+			break;
+		}
+		sched_yield();
+	}
+	// everything was either read or counted as lost
+	sBroadcastErrors[reader] += (read + broadcast_ring_lost(&sBroadcastRing, reader) != BROADCAST_STRESS_COUNT);
+	return NULL;
+}
+
+/**
+ * Reads every sample as one reader, alternating single and in-place reads.
+ */
+static void* broadcast_stress_consumer(void* cookie)
+{
+	size_t reader = (size_t)cookie;
+	uint32_t expected = 0;
+	while(expected < BROADCAST_STRESS_COUNT)
+	{
+		broadcast_span_t spans[2];
+		uint16_t sample;
+		if(expected & 1)
+		{
+			if(broadcast_ring_pop(&sBroadcastRing, reader, &sample) != buff_err_success)
+			{
+				sched_yield();
+				continue;
+			}
+			sBroadcastErrors[reader] += (sample != (uint16_t)expected++);
+		}
+		else if(broadcast_ring_peek_read(&sBroadcastRing, reader, spans))
+		{
+			size_t count = 0;
+			for(size_t s = 0; s < 2; s++)
+			{
+				for(size_t i = 0; i < spans[s].count; i++, count++)
+				{
+					sBroadcastErrors[reader] += (spans[s].data[i] != (uint16_t)expected++);
+				}
+			}
+			broadcast_ring_commit_read(&sBroadcastRing, reader, count);
+		}
+		else
+		{
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+/**
+ * What happens on each simulated tick while the ring_notify test blocks:
+ * from tick sNotifyPushAt on, one element is pushed per tick until
+ * sNotifyPushes are in, and at tick sNotifyStrangerAt the task gets a
+ * notification that has nothing to do with the ring. Ticks count from
+ * sNotifyStart, 0 means never.
+ */
+static ring_notify_t sNotifyRing;
+static uint32_t sNotifyStorage[8];
+static TickType_t sNotifyStart;
+static TickType_t sNotifyPushAt;
+static uint32_t sNotifyPushes;
+static TickType_t sNotifyStrangerAt;
+
+static void notify_blocked_tick(TickType_t inNow)
+{
+	TickType_t tick = inNow - sNotifyStart;
+	if(sNotifyPushAt && tick >= sNotifyPushAt && sNotifyPushes)
+	{
+		sNotifyPushes--;
+		ring_notify_push(&sNotifyRing, tick);
+	}
+	if(sNotifyStrangerAt && tick == sNotifyStrangerAt)
+	{
+		xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+	}
+}
+
+/**
+ * Start a ring_notify test step with the given producer and stranger.
+ */
+static void notify_script(TickType_t inPushAt, uint32_t inPushes, TickType_t inStrangerAt)
+{
+	sNotifyStart = gHostTicks;
+	sNotifyPushAt = inPushAt;
+	sNotifyPushes = inPushes;
+	sNotifyStrangerAt = inStrangerAt;
+	gHostNotificationsGiven = 0;
+}
+
+int main()
+{
+	UCUNIT_Init();
+
+	{
+		UCUNIT_TestcaseBegin("Handle validation");
+		cbuf_handle_t buf = circular_buf_init(TEST_BUF_SIZE);
+		uint32_t out = 0;
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_push(buf, 0xAA));
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_pop(buf, &out));
+		UCUNIT_CheckIsEqual(0xAA, out);
+		UCUNIT_CheckIsEqual(buff_err_invalid, circular_buf_push(NULL, 0xAA));
+		UCUNIT_CheckIsEqual(buff_err_invalid, circular_buf_pop(NULL, &out));
+
+		// a descriptor that was never initialized is rejected
+		circular_buf_t garbage = {0};
+		UCUNIT_CheckIsEqual(buff_err_invalid, circular_buf_push(&garbage, 0xAA));
+		circular_buf_free(buf);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Many live buffers");
+		cbuf_handle_t bufs[64];
+		for(int i = 0; i < 64; i++)
+		{
+			bufs[i] = circular_buf_init(TEST_BUF_SIZE);
+			UCUNIT_CheckIsEqual(buff_err_success, circular_buf_push(bufs[i], i));
+		}
+		for(int i = 63; i >= 0; i--)
+		{
+			uint32_t out = 0;
+			UCUNIT_CheckIsEqual(buff_err_success, circular_buf_pop(bufs[i], &out));
+			UCUNIT_CheckIsEqual((uint32_t)i, out);
+			circular_buf_free(bufs[i]);
+		}
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Bulk push and pop across the wrap");
+		cbuf_handle_t buf = circular_buf_init(8);
+		uint32_t in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+		uint32_t out[10] = {0};
+		size_t count = 0;
+
+		// move read/write to the middle so the next bulk ops wrap
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_push_n(buf, in, 5, &count));
+		UCUNIT_CheckIsEqual(5, count);
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_pop_n(buf, out, 5, &count));
+		UCUNIT_CheckIsEqual(5, count);
+
+		UCUNIT_CheckIsEqual(buff_err_full, circular_buf_push_n(buf, in, 10, &count));
+		UCUNIT_CheckIsEqual(8, count);
+		UCUNIT_CheckIsEqual(true, circular_buf_full(buf));
+
+		cbuf_span_t spans[2];
+		UCUNIT_CheckIsEqual(8, circular_buf_peek_read(buf, spans));
+		UCUNIT_CheckIsEqual(3, spans[0].count);
+		UCUNIT_CheckIsEqual(5, spans[1].count);
+		UCUNIT_CheckIsEqual(0, spans[0].data[0]);
+		UCUNIT_CheckIsEqual(3, spans[1].data[0]);
+
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_pop_n(buf, out, 10, &count));
+		UCUNIT_CheckIsEqual(8, count);
+		for(uint32_t i = 0; i < 8; i++)
+		{
+			UCUNIT_CheckIsEqual(i, out[i]);
+		}
+		UCUNIT_CheckIsEqual(buff_err_empty, circular_buf_pop_n(buf, out, 1, &count));
+		UCUNIT_CheckIsEqual(0, count);
+		circular_buf_free(buf);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Peek and commit in place");
+		cbuf_handle_t buf = circular_buf_init(4);
+		cbuf_span_t spans[2];
+		circular_buf_push(buf, 1);
+		circular_buf_push(buf, 2);
+		uint32_t out = 0;
+		circular_buf_pop(buf, &out);
+
+		UCUNIT_CheckIsEqual(3, circular_buf_peek_write(buf, spans));
+		UCUNIT_CheckIsEqual(2, spans[0].count);
+		UCUNIT_CheckIsEqual(1, spans[1].count);
+		spans[0].data[0] = 3;
+		spans[0].data[1] = 4;
+		spans[1].data[0] = 5;
+		UCUNIT_CheckIsEqual(buff_err_invalid, circular_buf_commit_write(buf, 4));
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_commit_write(buf, 3));
+		UCUNIT_CheckIsEqual(true, circular_buf_full(buf));
+
+		UCUNIT_CheckIsEqual(4, circular_buf_peek_read(buf, spans));
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_commit_read(buf, 2));
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_pop(buf, &out));
+		UCUNIT_CheckIsEqual(4, out);
+		UCUNIT_CheckIsEqual(buff_err_invalid, circular_buf_commit_read(buf, 2));
+		circular_buf_free(buf);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Resize keeps wrapped contents in order");
+		cbuf_handle_t buf = circular_buf_init(4);
+		uint32_t out = 0;
+		circular_buf_push(buf, 0);
+		circular_buf_push(buf, 0);
+		circular_buf_pop(buf, &out);
+		circular_buf_pop(buf, &out);
+		for(uint32_t i = 1; i <= 5; i++)
+		{
+			UCUNIT_CheckIsEqual(buff_err_success, circular_buf_push_resize(&buf, i));
+		}
+		UCUNIT_CheckIsEqual(8, circular_buf_capacity(buf));
+		for(uint32_t i = 1; i <= 5; i++)
+		{
+			UCUNIT_CheckIsEqual(buff_err_success, circular_buf_pop(buf, &out));
+			UCUNIT_CheckIsEqual(i, out);
+		}
+		circular_buf_free(buf);
+		UCUNIT_TestcaseEnd();
+	}
+
+#if CIRCULAR_BUF_POOL_SIZE
+	{
+		UCUNIT_TestcaseBegin("Static buffers from the descriptor pool");
+		static uint32_t storage[CIRCULAR_BUF_POOL_SIZE + 1][TEST_BUF_SIZE];
+		cbuf_handle_t bufs[CIRCULAR_BUF_POOL_SIZE];
+		for(int i = 0; i < CIRCULAR_BUF_POOL_SIZE; i++)
+		{
+			bufs[i] = circular_buf_init_static(storage[i], TEST_BUF_SIZE);
+			UCUNIT_CheckIsNotNull(bufs[i]);
+			UCUNIT_CheckIsEqual(storage[i], bufs[i]->buffer);
+		}
+		UCUNIT_CheckIsNull(circular_buf_init_static(storage[CIRCULAR_BUF_POOL_SIZE], TEST_BUF_SIZE));
+
+		uint32_t out = 0;
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_push(bufs[0], 0xAA));
+		UCUNIT_CheckIsEqual(0xAA, storage[0][0]);
+		UCUNIT_CheckIsEqual(buff_err_invalid, circular_buf_resize(&bufs[0], TEST_BUF_SIZE * 2));
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_pop(bufs[0], &out));
+
+		// freeing returns the descriptor to the pool
+		circular_buf_free(bufs[0]);
+		UCUNIT_CheckIsEqual(buff_err_invalid, circular_buf_push(bufs[0], 0xAA));
+		bufs[0] = circular_buf_init_static(storage[CIRCULAR_BUF_POOL_SIZE], TEST_BUF_SIZE);
+		UCUNIT_CheckIsNotNull(bufs[0]);
+
+		for(int i = 0; i < CIRCULAR_BUF_POOL_SIZE; i++)
+		{
+			circular_buf_free(bufs[i]);
+		}
+		UCUNIT_TestcaseEnd();
+	}
+#endif
+
+	{
+		UCUNIT_TestcaseBegin("SPSC ring basics");
+		spsc_ring_t ring;
+		uint32_t storage[4];
+		uint32_t out = 0;
+		UCUNIT_CheckIsEqual(buff_err_invalid, spsc_ring_init(&ring, storage, 3));
+		UCUNIT_CheckIsEqual(buff_err_invalid, spsc_ring_init(&ring, storage, 0));
+		UCUNIT_CheckIsEqual(buff_err_success, spsc_ring_init(&ring, storage, 4));
+		UCUNIT_CheckIsEqual(buff_err_empty, spsc_ring_pop(&ring, &out));
+		for(uint32_t i = 0; i < 4; i++)
+		{
+			UCUNIT_CheckIsEqual(buff_err_success, spsc_ring_push(&ring, i));
+		}
+		UCUNIT_CheckIsEqual(true, spsc_ring_full(&ring));
+		UCUNIT_CheckIsEqual(buff_err_full, spsc_ring_push(&ring, 4));
+		// wrap a few times
+		for(uint32_t i = 0; i < 10; i++)
+		{
+			UCUNIT_CheckIsEqual(buff_err_success, spsc_ring_pop(&ring, &out));
+			UCUNIT_CheckIsEqual(i, out);
+			UCUNIT_CheckIsEqual(buff_err_success, spsc_ring_push(&ring, i + 4));
+		}
+		UCUNIT_CheckIsEqual(4, spsc_ring_size(&ring));
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("SPSC ring element widths");
+		spsc_ring_u8_t bytes;
+		uint8_t byteStorage[8];
+		uint8_t byteOut = 0;
+		spsc_ring_u8_init(&bytes, byteStorage, 8);
+		for(uint32_t i = 0; i < 300; i++)
+		{
+			UCUNIT_CheckIsEqual(buff_err_success, spsc_ring_u8_push(&bytes, (uint8_t)i));
+			UCUNIT_CheckIsEqual(buff_err_success, spsc_ring_u8_pop(&bytes, &byteOut));
+			UCUNIT_CheckIsEqual((uint8_t)i, byteOut);
+		}
+
+		spsc_ring_u16_t halves;
+		uint16_t halfStorage[8];
+		uint16_t in[6] = {4095, 1, 2, 3, 4, 5};
+		uint16_t out[6] = {0};
+		size_t count = 0;
+		spsc_ring_u16_init(&halves, halfStorage, 8);
+		spsc_ring_u16_push_n(&halves, in, 6, &count);
+		spsc_ring_u16_pop_n(&halves, out, 6, &count);
+		// second round wraps
+		UCUNIT_CheckIsEqual(buff_err_success, spsc_ring_u16_push_n(&halves, in, 6, &count));
+		UCUNIT_CheckIsEqual(6, count);
+		spsc_ring_u16_span_t spans[2];
+		UCUNIT_CheckIsEqual(6, spsc_ring_u16_peek_read(&halves, spans));
+		UCUNIT_CheckIsEqual(2, spans[0].count);
+		UCUNIT_CheckIsEqual(4095, spans[0].data[0]);
+		UCUNIT_CheckIsEqual(buff_err_success, spsc_ring_u16_pop_n(&halves, out, 6, &count));
+		UCUNIT_CheckIsEqual(4095, out[0]);
+		UCUNIT_CheckIsEqual(5, out[5]);
+		UCUNIT_CheckIsEqual(buff_err_empty, spsc_ring_u16_pop_n(&halves, out, 6, &count));
+
+		test_pair_ring_t pairs;
+		test_pair_t pairStorage[2];
+		test_pair_t pair = { 1234, 7 };
+		test_pair_ring_init(&pairs, pairStorage, 2);
+		UCUNIT_CheckIsEqual(buff_err_success, test_pair_ring_push(&pairs, pair));
+		pair.code = 0;
+		UCUNIT_CheckIsEqual(buff_err_success, test_pair_ring_pop(&pairs, &pair));
+		UCUNIT_CheckIsEqual(1234, pair.code);
+		UCUNIT_CheckIsEqual(7, pair.channel);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("SPSC ring threaded stress");
+		spsc_ring_init(&sStressRing, sStressStorage, 256);
+		struct timespec start, end;
+		pthread_t producer, consumer;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		pthread_create(&consumer, NULL, spsc_stress_consumer, NULL);
+		pthread_create(&producer, NULL, spsc_stress_producer, NULL);
+		pthread_join(producer, NULL);
+		pthread_join(consumer, NULL);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+		printf("%u elements in %.3f s, %.1f M ops/s\n",
+				SPSC_STRESS_COUNT, seconds, SPSC_STRESS_COUNT / seconds / 1e6);
+		UCUNIT_CheckIsEqual(0, sStressErrors);
+		UCUNIT_CheckIsEqual(true, spsc_ring_empty(&sStressRing));
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Ping-pong block handoff");
+		pingpong_t pp;
+		uint16_t storage[8];
+		size_t count = 0;
+		UCUNIT_CheckIsEqual(buff_err_invalid, pingpong_init(&pp, storage, 0));
+		UCUNIT_CheckIsEqual(buff_err_success, pingpong_init(&pp, storage, 4));
+		UCUNIT_CheckIsNull(pingpong_acquire(&pp, &count));
+
+		for(uint16_t i = 0; i < 3; i++)
+		{
+			UCUNIT_CheckIsEqual(false, pingpong_push(&pp, i));
+		}
+		UCUNIT_CheckIsEqual(true, pingpong_push(&pp, 3));
+
+		const uint16_t* block = pingpong_acquire(&pp, &count);
+		UCUNIT_CheckIsEqual(storage, block);
+		UCUNIT_CheckIsEqual(4, count);
+
+		// producer fills the other block while we hold this one
+		for(uint16_t i = 10; i < 13; i++)
+		{
+			pingpong_push(&pp, i);
+		}
+		UCUNIT_CheckIsEqual(0, block[0]);
+		UCUNIT_CheckIsEqual(3, block[3]);
+		UCUNIT_CheckIsEqual(false, pingpong_push(&pp, 13));
+		UCUNIT_CheckIsEqual(1, pp.overruns);
+
+		pingpong_release(&pp);
+		for(uint16_t i = 20; i < 23; i++)
+		{
+			pingpong_push(&pp, i);
+		}
+		UCUNIT_CheckIsEqual(true, pingpong_push(&pp, 23));
+		block = pingpong_acquire(&pp, &count);
+		UCUNIT_CheckIsEqual(storage + 4, block);
+		UCUNIT_CheckIsEqual(20, block[0]);
+		pingpong_release(&pp);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Circular buffer full policy");
+		cbuf_handle_t buf = circular_buf_init(4);
+		uint32_t out = 0;
+		circular_buf_set_policy(buf, cbuf_policy_reject);
+		for(uint32_t i = 0; i < 4; i++)
+		{
+			UCUNIT_CheckIsEqual(buff_err_success, circular_buf_push(buf, i));
+		}
+		UCUNIT_CheckIsEqual(buff_err_full, circular_buf_push(buf, 4));
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_pop(buf, &out));
+		UCUNIT_CheckIsEqual(0, out);
+
+		circular_buf_set_policy(buf, cbuf_policy_overwrite);
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_push(buf, 5));
+		// still reports the wrap, but stores the element
+		UCUNIT_CheckIsEqual(buff_err_full, circular_buf_push(buf, 6));
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_pop(buf, &out));
+		UCUNIT_CheckIsEqual(2, out);
+#if RING_STATS
+		UCUNIT_CheckIsEqual(6, buf->stats.pushes);
+		UCUNIT_CheckIsEqual(2, buf->stats.pops);
+		UCUNIT_CheckIsEqual(1, buf->stats.overwrites);
+		UCUNIT_CheckIsEqual(1, buf->stats.rejected);
+		UCUNIT_CheckIsEqual(4, buf->stats.peak);
+
+		// counters and registration follow the buffer through a resize
+		RING_STATS_REGISTER(buf, "test buffer");
+		UCUNIT_CheckIsEqual(buff_err_success, circular_buf_resize(&buf, 8));
+		UCUNIT_CheckIsEqual(6, buf->stats.pushes);
+		ring_stats_log_all();
+#endif
+		circular_buf_free(buf);
+		UCUNIT_TestcaseEnd();
+	}
+
+#if RING_STATS
+	{
+		UCUNIT_TestcaseBegin("SPSC ring counters");
+		spsc_ring_u8_t ring;
+		uint8_t storage[4];
+		uint8_t out = 0;
+		spsc_ring_u8_init(&ring, storage, 4);
+		for(uint8_t i = 0; i < 5; i++)
+		{
+			spsc_ring_u8_push(&ring, i);
+		}
+		spsc_ring_u8_pop(&ring, &out);
+		UCUNIT_CheckIsEqual(4, ring.stats.pushes);
+		UCUNIT_CheckIsEqual(1, ring.stats.pops);
+		UCUNIT_CheckIsEqual(1, ring.stats.rejected);
+		UCUNIT_CheckIsEqual(0, ring.stats.overwrites);
+		UCUNIT_CheckIsEqual(4, ring.stats.peak);
+		spsc_ring_u8_stats_reset(&ring);
+		UCUNIT_CheckIsEqual(0, ring.stats.pushes);
+		UCUNIT_CheckIsEqual(3, spsc_ring_u8_size(&ring));
+		UCUNIT_TestcaseEnd();
+	}
+#endif
+
+	{
+		UCUNIT_TestcaseBegin("Notifying ring");
+		uint32_t out = 0;
+		gHostBlockedTick = notify_blocked_tick;
+		UCUNIT_CheckIsEqual(buff_err_invalid, ring_notify_init(&sNotifyRing, sNotifyStorage, 8, 9));
+		UCUNIT_CheckIsEqual(buff_err_success, ring_notify_init(&sNotifyRing, sNotifyStorage, 8, 0));
+		UCUNIT_CheckIsEqual(4, sNotifyRing.watermark);
+
+		// nothing arrives: the wait lasts exactly its timeout, a zero timeout does not block
+		notify_script(0, 0, 0);
+		UCUNIT_CheckIsEqual(0, ring_notify_wait(&sNotifyRing, 1, 10));
+		UCUNIT_CheckIsEqual(10, gHostTicks - sNotifyStart);
+		UCUNIT_CheckIsEqual(buff_err_empty, ring_notify_pop(&sNotifyRing, &out, 0));
+		UCUNIT_CheckIsEqual(10, gHostTicks - sNotifyStart);
+
+		// one element per tick wakes a watermark wait once, at the watermark
+		notify_script(1, 6, 0);
+		UCUNIT_CheckIsEqual(4, ring_notify_wait_watermark(&sNotifyRing, 100));
+		UCUNIT_CheckIsEqual(4, gHostTicks - sNotifyStart);
+		UCUNIT_CheckIsEqual(1, gHostNotificationsGiven);
+		UCUNIT_CheckIsEqual(buff_err_success, ring_notify_pop(&sNotifyRing, &out, 10));
+		UCUNIT_CheckIsEqual(1, out);
+		UCUNIT_CheckIsEqual(4, gHostTicks - sNotifyStart);
+
+		// already at the level: no sleep and no notification
+		notify_script(0, 0, 0);
+		UCUNIT_CheckIsEqual(3, ring_notify_wait(&sNotifyRing, 2, 10));
+		UCUNIT_CheckIsEqual(0, gHostNotificationsGiven);
+		while(ring_notify_pop(&sNotifyRing, &out, 0) == buff_err_success)
+		{
+		}
+
+		// a notification for something else does not end the wait early
+		notify_script(5, 1, 2);
+		UCUNIT_CheckIsEqual(buff_err_success, ring_notify_pop(&sNotifyRing, &out, 10));
+		UCUNIT_CheckIsEqual(5, out);
+		UCUNIT_CheckIsEqual(5, gHostTicks - sNotifyStart);
+		notify_script(0, 0, 3);
+		UCUNIT_CheckIsEqual(0, ring_notify_wait(&sNotifyRing, 1, 7));
+		UCUNIT_CheckIsEqual(7, gHostTicks - sNotifyStart);
+
+		// a wake given just as a wait timed out does not cut the next one short
+		notify_script(1, 1, 0);
+		UCUNIT_CheckIsEqual(1, ring_notify_wait(&sNotifyRing, 2, 3));
+		UCUNIT_CheckIsEqual(3, gHostTicks - sNotifyStart);
+		xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+		notify_script(0, 0, 0);
+		UCUNIT_CheckIsEqual(1, ring_notify_wait(&sNotifyRing, 2, 6));
+		UCUNIT_CheckIsEqual(6, gHostTicks - sNotifyStart);
+		UCUNIT_CheckIsEqual(0, gHostNotifyValue);
+
+		// an ISR producer asks for a yield only when it wakes the consumer
+		BaseType_t woken = pdFALSE;
+		ring_notify_pop(&sNotifyRing, &out, 0);
+		UCUNIT_CheckIsEqual(buff_err_success, ring_notify_push_from_isr(&sNotifyRing, 7, &woken));
+		UCUNIT_CheckIsEqual(pdFALSE, woken);
+		gHostBlockedTick = NULL;
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Broadcast ring backpressure");
+		broadcast_ring_t ring;
+		uint16_t storage[4];
+		uint16_t out = 0;
+		size_t fast = 0, slow = 0, extra = 0;
+		UCUNIT_CheckIsEqual(buff_err_invalid, broadcast_ring_init(&ring, storage, 3, cbuf_policy_reject));
+		UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_init(&ring, storage, 4, cbuf_policy_reject));
+		UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_attach(&ring, &fast));
+		UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_attach(&ring, &slow));
+		UCUNIT_CheckIsEqual(true, fast != slow);
+		UCUNIT_CheckIsEqual(buff_err_empty, broadcast_ring_pop(&ring, fast, &out));
+
+		for(uint16_t i = 0; i < 4; i++)
+		{
+			UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_push(&ring, i));
+			UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_pop(&ring, fast, &out));
+			UCUNIT_CheckIsEqual(i, out);
+		}
+		// the slow reader holds the writer back
+		UCUNIT_CheckIsEqual(4, broadcast_ring_slowest(&ring));
+		UCUNIT_CheckIsEqual(buff_err_full, broadcast_ring_push(&ring, 4));
+		UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_pop(&ring, slow, &out));
+		UCUNIT_CheckIsEqual(0, out);
+		UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_push(&ring, 4));
+		UCUNIT_CheckIsEqual(1, broadcast_ring_size(&ring, fast));
+		UCUNIT_CheckIsEqual(4, broadcast_ring_size(&ring, slow));
+
+		// a new reader starts at the head, a detached one stops counting
+		UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_attach(&ring, &extra));
+		UCUNIT_CheckIsEqual(0, broadcast_ring_size(&ring, extra));
+		broadcast_ring_detach(&ring, slow);
+		UCUNIT_CheckIsEqual(1, broadcast_ring_slowest(&ring));
+		UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_push(&ring, 5));
+		UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_pop(&ring, extra, &out));
+		UCUNIT_CheckIsEqual(5, out);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Broadcast ring overwrite");
+		broadcast_ring_t ring;
+		uint16_t storage[4];
+		uint16_t out = 0;
+		size_t fast = 0, slow = 0;
+		broadcast_span_t spans[2];
+		broadcast_ring_init(&ring, storage, 4, cbuf_policy_overwrite);
+		broadcast_ring_attach(&ring, &fast);
+		broadcast_ring_attach(&ring, &slow);
+		for(uint16_t i = 0; i < 10; i++)
+		{
+			broadcast_ring_push(&ring, i);
+			broadcast_ring_pop(&ring, fast, &out);
+		}
+		UCUNIT_CheckIsEqual(9, out);
+		UCUNIT_CheckIsEqual(0, broadcast_ring_lost(&ring, fast));
+
+		// the slow reader skips to the oldest sample the next push cannot be
+		// writing over, which leaves capacity - 1
+		UCUNIT_CheckIsEqual(buff_err_invalid, broadcast_ring_init(&ring, storage, 1, cbuf_policy_overwrite));
+		UCUNIT_CheckIsEqual(3, broadcast_ring_size(&ring, slow));
+		UCUNIT_CheckIsEqual(3, broadcast_ring_peek_read(&ring, slow, spans));
+		UCUNIT_CheckIsEqual(7, broadcast_ring_lost(&ring, slow));
+		UCUNIT_CheckIsEqual(7, spans[0].data[0]);
+		UCUNIT_CheckIsEqual(1, spans[0].count);
+		UCUNIT_CheckIsEqual(8, spans[1].data[0]);
+		UCUNIT_CheckIsEqual(2, spans[1].count);
+
+		// overwritten while peeked, so the commit is refused
+		broadcast_ring_push(&ring, 10);
+		UCUNIT_CheckIsEqual(buff_err_full, broadcast_ring_commit_read(&ring, slow, 3));
+		UCUNIT_CheckIsEqual(8, broadcast_ring_lost(&ring, slow));
+		UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_pop(&ring, slow, &out));
+		UCUNIT_CheckIsEqual(8, out);
+
+		// the writer stopped between storing sample 4 over sample 0's slot
+		// and publishing it: a full lap behind, the reader must not take it
+		broadcast_ring_init(&ring, storage, 4, cbuf_policy_overwrite);
+		broadcast_ring_attach(&ring, &slow);
+		for(uint16_t i = 0; i < 4; i++)
+		{
+			broadcast_ring_push(&ring, i);
+		}
+		storage[ring.head & ring.mask] = 4;
+		UCUNIT_CheckIsEqual(buff_err_success, broadcast_ring_pop(&ring, slow, &out));
+		UCUNIT_CheckIsEqual(1, out);
+		UCUNIT_CheckIsEqual(1, broadcast_ring_lost(&ring, slow));
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Broadcast ring threaded stress");
+		pthread_t producer, consumers[2];
+		size_t readers[2];
+		broadcast_ring_init(&sBroadcastRing, sBroadcastStorage, 256, cbuf_policy_reject);
+		broadcast_ring_attach(&sBroadcastRing, &readers[0]);
+		broadcast_ring_attach(&sBroadcastRing, &readers[1]);
+		for(size_t i = 0; i < 2; i++)
+		{
+			pthread_create(&consumers[i], NULL, broadcast_stress_consumer, (void*)readers[i]);
+		}
+		pthread_create(&producer, NULL, broadcast_stress_producer, NULL);
+		pthread_join(producer, NULL);
+		pthread_join(consumers[0], NULL);
+		pthread_join(consumers[1], NULL);
+		UCUNIT_CheckIsEqual(0, sBroadcastErrors[0]);
+		UCUNIT_CheckIsEqual(0, sBroadcastErrors[1]);
+		UCUNIT_CheckIsEqual(0, broadcast_ring_slowest(&sBroadcastRing));
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Broadcast ring threaded overwrite stress");
+		pthread_t producer, consumers[2];
+		size_t readers[2];
+		sBroadcastErrors[0] = sBroadcastErrors[1] = 0;
+		sBroadcastDone = false;
+		broadcast_ring_init(&sBroadcastRing, sBroadcastStorage, 256, cbuf_policy_overwrite);
+		broadcast_ring_attach(&sBroadcastRing, &readers[0]);
+		broadcast_ring_attach(&sBroadcastRing, &readers[1]);
+		for(size_t i = 0; i < 2; i++)
+		{
+			pthread_create(&consumers[i], NULL, broadcast_overwrite_consumer, (void*)readers[i]);
+		}
+		pthread_create(&producer, NULL, broadcast_overwrite_producer, NULL);
+		pthread_join(producer, NULL);
+		pthread_join(consumers[0], NULL);
+		pthread_join(consumers[1], NULL);
+		UCUNIT_CheckIsEqual(0, sBroadcastErrors[0]);
+		UCUNIT_CheckIsEqual(0, sBroadcastErrors[1]);
+		// the readers were lapped, or this proved nothing
+		UCUNIT_CheckIsEqual(true, broadcast_ring_lost(&sBroadcastRing, readers[0]) +
+				                  broadcast_ring_lost(&sBroadcastRing, readers[1]) > 0);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Streaming statistics");
+		stream_stats_t block, lifetime, signedStats;
+		uint16_t samples[64];
+		double sum = 0, sumSquares = 0;
+		stream_stats_reset(&lifetime);
+		UCUNIT_CheckIsEqual(0, stream_stats_sum_squared_deviations(&lifetime));
+		for(uint32_t i = 0; i < 64; i++)
+		{
+			samples[i] = (uint16_t)((i * 2654435761u) >> 20);
+			sum += samples[i];
+		}
+		double mean = sum / 64;
+		for(uint32_t i = 0; i < 64; i++)
+		{
+			sumSquares += (samples[i] - mean) * (samples[i] - mean);
+		}
+
+		stream_stats_reset(&block);
+		stream_stats_add_block_u16(&block, samples, 64);
+		UCUNIT_CheckIsEqual(64, block.count);
+		UCUNIT_CheckIsEqual((uint64_t)sumSquares, stream_stats_sum_squared_deviations(&block));
+		UCUNIT_CheckIsEqual(true, fabs(stream_stats_mean(&block) - mean) < 1e-3);
+
+		// the block path and the per-sample path agree
+		stream_stats_reset(&signedStats);
+		for(uint32_t i = 0; i < 64; i++)
+		{
+			stream_stats_add(&signedStats, samples[i]);
+		}
+		UCUNIT_CheckIsEqual(block.sumSquares, signedStats.sumSquares);
+		UCUNIT_CheckIsEqual(block.min, signedStats.min);
+		UCUNIT_CheckIsEqual(block.max, signedStats.max);
+
+		// a year of blocks at the app's rate merges without losing the variance
+		for(uint32_t i = 0; i < 5000000; i++)
+		{
+			stream_stats_merge(&lifetime, &block);
+		}
+		UCUNIT_CheckIsEqual(320000000u, lifetime.count);
+		UCUNIT_CheckIsEqual(true, fabs(stream_stats_sum_squared_deviations(&lifetime) - sumSquares * 5000000.0) <= 1.0);
+		UCUNIT_CheckIsEqual(true, fabs(stream_stats_variance(&lifetime) / (sumSquares / 64) - 1.0) < 1e-6);
+
+		// signed samples around zero
+		stream_stats_reset(&signedStats);
+		stream_stats_add(&signedStats, -65535);
+		stream_stats_add(&signedStats, 65535);
+		stream_stats_add(&signedStats, -3);
+		UCUNIT_CheckIsEqual(-65535, signedStats.min);
+		UCUNIT_CheckIsEqual(65535, signedStats.max);
+		UCUNIT_CheckIsEqual(-3, signedStats.sum);
+		// 2 * 65535^2 + 9 - 9 / 3
+		UCUNIT_CheckIsEqual(8589672456ull, stream_stats_sum_squared_deviations(&signedStats));
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Fixed-point ADC statistics match float");
+		// one ADC LSB in millivolts
+		const double lsbMv = 3300.0 / 4096.0;
+		stream_stats_t stats;
+		adc_stats_report_t report;
+		uint16_t codes[64];
+		uint32_t seed = 12345;
+		stream_stats_reset(&stats);
+		adc_stats_report(&stats, &report);
+		UCUNIT_CheckIsEqual(0, report.meanMv);
+
+		for(uint32_t block = 0; block < 200; block++)
+		{
+			// reference: what dsp_callback used to do, in double
+			double minV = 1e9, maxV = 0, sumV = 0, sumSqV = 0;
+			uint32_t spread = 1 + block * 20;
+			for(uint32_t i = 0; i < 64; i++)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				uint32_t code = 2048 + (seed >> 16) % spread - spread / 2;
+				codes[i] = (uint16_t)(code > 4095 ? 4095 : code);
+				double volts = codes[i] * (3.300 / 4096.0);
+				minV = volts < minV ? volts : minV;
+				maxV = volts > maxV ? volts : maxV;
+				sumV += volts;
+			}
+			double meanV = sumV / 64;
+			for(uint32_t i = 0; i < 64; i++)
+			{
+				double d = codes[i] * (3.300 / 4096.0) - meanV;
+				sumSqV += d * d;
+			}
+
+			stream_stats_reset(&stats);
+			stream_stats_add_block_u16(&stats, codes, 64);
+			adc_stats_report(&stats, &report);
+			UCUNIT_CheckIsEqual(true, fabs(report.minMv - minV * 1000) <= lsbMv);
+			UCUNIT_CheckIsEqual(true, fabs(report.maxMv - maxV * 1000) <= lsbMv);
+			UCUNIT_CheckIsEqual(true, fabs(report.meanMv - meanV * 1000) <= lsbMv);
+			UCUNIT_CheckIsEqual(true, fabs(sqrt(report.varianceMv2) - sqrt(sumSqV / 64) * 1000) <= lsbMv);
+			UCUNIT_CheckIsEqual(true, fabs(report.stdDevMv - sqrt(sumSqV / 64) * 1000) <= lsbMv);
+		}
+		UCUNIT_CheckIsEqual(0, adc_code_to_mv(0));
+		UCUNIT_CheckIsEqual(3299, adc_code_to_mv(4095));
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Calibrated code to millivolt conversion");
+		// nominal: every code as VREF / 4096 rounded, in one and in blocks
+		uint16_t codes[4096];
+		uint16_t mv[4096];
+		for(uint32_t code = 0; code < 4096; code++)
+		{
+			codes[code] = (uint16_t)code;
+		}
+		adc_block_to_mv(codes, mv, 4096);
+		uint32_t mismatches = 0;
+		for(uint32_t code = 0; code < 4096; code++)
+		{
+			mismatches += mv[code] != (code * 3300 + 2048) / 4096;
+			mismatches += adc_code_to_mv(code) != mv[code];
+			mismatches += adc_span_to_mv(code) != mv[code];
+		}
+		UCUNIT_CheckIsEqual(0, mismatches);
+
+		// millivolts back to codes, as the trigger levels are set
+		mismatches = 0;
+		for(uint32_t level = 0; level < 3300; level++)
+		{
+			mismatches += adc_mv_to_code(level) != ((level << 12) + 1650) / 3300;
+			mismatches += adc_mv_to_span(level) != adc_mv_to_code(level);
+		}
+		UCUNIT_CheckIsEqual(0, mismatches);
+		UCUNIT_CheckIsEqual(4095, adc_mv_to_code(3300));
+		UCUNIT_CheckIsEqual(4095, adc_mv_to_code(4000));
+
+		// a converter reading 1 % high and 15 mV over
+		UCUNIT_CheckIsEqual(buff_err_invalid, adc_calibrate(ADC_CAL_MAX_GAIN_PPM + 1, 0));
+		UCUNIT_CheckIsEqual(buff_err_invalid, adc_calibrate(0, -ADC_CAL_MAX_OFFSET_UV - 1));
+		UCUNIT_CheckIsEqual(3299, adc_code_to_mv(4095));
+		UCUNIT_CheckIsEqual(buff_err_success, adc_calibrate(10000, 15000));
+		double worst = 0;
+		for(uint32_t trueMv = 0; trueMv <= 3200; trueMv++)
+		{
+			uint32_t code = (uint32_t)lround((trueMv * 1.01 + 15) * 4096 / 3300);
+			// a code is 0.8 mV, so rounding to a code and then to a mV is within 0.9
+			worst = fmax(worst, fabs((double)adc_code_to_mv(code) - trueMv));
+		}
+		UCUNIT_CheckIsEqual(true, worst <= 0.9);
+		UCUNIT_CheckIsEqual(0, adc_code_to_mv(0));
+		UCUNIT_CheckIsEqual(990, adc_span_to_mv(1241));
+		// and back: the code the converter gives for each true level
+		mismatches = 0;
+		for(uint32_t trueMv = 0; trueMv <= 3200; trueMv++)
+		{
+			mismatches += adc_mv_to_code(trueMv) != lround((trueMv * 1.01 + 15) * 4096 / 3300);
+		}
+		UCUNIT_CheckIsEqual(0, mismatches);
+		UCUNIT_CheckIsEqual(lround(50 * 1.01 * 4096 / 3300), adc_mv_to_span(50));
+
+		// the report uses the same calibration
+		stream_stats_t stats;
+		adc_stats_report_t report;
+		stream_stats_reset(&stats);
+		for(uint32_t i = 0; i < 64; i++)
+		{
+			stream_stats_add(&stats, i & 1 ? 2500 : 1500);
+		}
+		adc_stats_report(&stats, &report);
+		UCUNIT_CheckIsEqual(lround((2000 * 3300.0 / 4096 - 15) / 1.01), report.meanMv);
+		UCUNIT_CheckIsEqual(lround(500 * 3300.0 / 4096 / 1.01), report.stdDevMv);
+		UCUNIT_CheckIsEqual(true, labs((long)report.varianceMv2 - lround(pow(500 * 3300.0 / 4096 / 1.01, 2))) <= 1);
+		UCUNIT_CheckIsEqual(report.minMv, adc_code_to_mv(1500));
+
+		UCUNIT_CheckIsEqual(buff_err_success, adc_calibrate(0, 0));
+		UCUNIT_CheckIsEqual(3299, adc_code_to_mv(4095));
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Integer square root");
+		uint32_t errors = 0;
+		// both sides of every perfect square in 32 bits
+		for(uint32_t r = 1; r < 65536; r++)
+		{
+			errors += isqrt32(r * r) != r;
+			errors += isqrt32(r * r - 1) != r - 1;
+		}
+		UCUNIT_CheckIsEqual(0, errors);
+		UCUNIT_CheckIsEqual(0, isqrt32(0));
+		UCUNIT_CheckIsEqual(65535, isqrt32(UINT32_MAX));
+		UCUNIT_CheckIsEqual(UINT32_MAX, isqrt64(UINT64_MAX));
+
+		// random values against libm
+		uint64_t seed = 88172645463325252ull;
+		for(uint32_t i = 0; i < 1000000; i++)
+		{
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			uint32_t small = (uint32_t)seed;
+			errors += isqrt32(small) != (uint32_t)sqrt((double)small);
+			uint64_t big = seed >> (i & 31);
+			uint64_t root = isqrt64(big);
+			errors += root * root > big || (root + 1) * (root + 1) <= big;
+		}
+		UCUNIT_CheckIsEqual(0, errors);
+
+		// fixed-point standard deviation
+		stream_stats_t stats;
+		stream_stats_reset(&stats);
+		double sum = 0, sumSquares = 0;
+		for(int32_t i = -500; i < 1500; i += 7)
+		{
+			stream_stats_add(&stats, i);
+			sum += i;
+			sumSquares += (double)i * i;
+		}
+		double mean = sum / stats.count;
+		double stdDev = sqrt(sumSquares / stats.count - mean * mean);
+		UCUNIT_CheckIsEqual(true, fabs(stream_stats_stddev_q(&stats, 8) / 256.0 - stdDev) < 1.0 / 256);
+		UCUNIT_CheckIsEqual(true, fabs(stream_stats_stddev_q(&stats, 15) / 32768.0 - stdDev) < 1.0 / 32768);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("CMSIS-DSP statistics kernels");
+		q15_t q15[64];
+		q31_t q31[64];
+		double sum = 0, sumSquares = 0;
+		for(uint32_t i = 0; i < 64; i++)
+		{
+			q15[i] = (q15_t)(((int32_t)((i * 2654435761u) >> 16) & 0x7FFF) - 16384);
+			q31[i] = (q31_t)q15[i] << 16;
+			sum += q15[i];
+			sumSquares += (double)q15[i] * q15[i];
+		}
+		double mean = sum / 64;
+		double stdDev = sqrt((sumSquares - sum * sum / 64) / 63);
+		double rms = sqrt(sumSquares / 64);
+
+		q15_t r15;
+		q31_t r31;
+		uint32_t index;
+		arm_max_q15(q15, 64, &r15, &index);
+		UCUNIT_CheckIsEqual(q15[index], r15);
+		arm_min_q31(q31, 64, &r31, &index);
+		UCUNIT_CheckIsEqual(q31[index], r31);
+		for(uint32_t i = 0; i < 64; i++)
+		{
+			UCUNIT_CheckIsEqual(true, q15[i] <= r15 && q31[i] >= r31);
+		}
+		arm_mean_q15(q15, 64, &r15);
+		UCUNIT_CheckIsEqual(true, fabs(r15 - mean) < 1);
+		arm_mean_q31(q31, 64, &r31);
+		UCUNIT_CheckIsEqual(true, fabs(r31 / 65536.0 - mean) < 1);
+		arm_std_q15(q15, 64, &r15);
+		UCUNIT_CheckIsEqual(true, fabs(r15 - stdDev) <= 2);
+		arm_std_q31(q31, 64, &r31);
+		UCUNIT_CheckIsEqual(true, fabs(r31 / 65536.0 - stdDev) <= 1);
+		arm_rms_q15(q15, 64, &r15);
+		UCUNIT_CheckIsEqual(true, fabs(r15 - rms) <= 2);
+		arm_rms_q31(q31, 64, &r31);
+		UCUNIT_CheckIsEqual(true, fabs(r31 / 65536.0 - rms) <= 1);
+		UCUNIT_CheckIsEqual(ARM_MATH_ARGUMENT_ERROR, arm_sqrt_q15(-1, &r15));
+		arm_sqrt_q15(8192, &r15);
+		UCUNIT_CheckIsEqual(16384, r15);
+
+		// the app's path: ADC codes in place, against the hand-written stats
+		uint16_t codes[64];
+		stream_stats_t stats;
+		dsp_block_stats_t block;
+		for(uint32_t i = 0; i < 64; i++)
+		{
+			codes[i] = (uint16_t)(2048 + 1200 * sin(i * 0.3));
+		}
+		stream_stats_reset(&stats);
+		stream_stats_add_block_u16(&stats, codes, 64);
+		dsp_block_stats_q15((q15_t*)codes, 64, DSP_STATS_ADC_HEADROOM, &block);
+		UCUNIT_CheckIsEqual(stats.min, block.min);
+		UCUNIT_CheckIsEqual(stats.max, block.max);
+		UCUNIT_CheckIsEqual(true, abs(block.mean - (int32_t)(stats.sum / 64)) <= 1);
+		// the population standard deviation, as the stream path reports
+		double population = stream_stats_stddev_q(&stats, 8) / 256.0;
+		UCUNIT_CheckIsEqual(true, fabs(block.stdDev - population) <= 1);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Sliding window statistics");
+		enum { WINDOW = 7, SAMPLES = 5000 };
+		static uint16_t history[SAMPLES];
+		uint16_t storage[SLIDING_STATS_STORAGE(WINDOW)];
+		sliding_stats_t window;
+		stream_stats_t snapshot;
+		uint32_t errors = 0;
+		uint32_t seed = 1;
+		UCUNIT_CheckIsEqual(buff_err_invalid, sliding_stats_init(&window, storage, 0));
+		UCUNIT_CheckIsEqual(buff_err_success, sliding_stats_init(&window, storage, WINDOW));
+		sliding_stats_snapshot(&window, &snapshot);
+		UCUNIT_CheckIsEqual(0, snapshot.count);
+
+		for(uint32_t i = 0; i < SAMPLES; i++)
+		{
+			// runs of rising, falling and repeated values exercise the deques
+			seed = seed * 1103515245u + 12345u;
+			uint32_t mode = (i / 50) % 3;
+			history[i] = mode == 0 ? (uint16_t)(seed >> 16) :
+					     mode == 1 ? (uint16_t)(60000 - i) : (uint16_t)((seed >> 30) * 1000);
+			sliding_stats_push(&window, history[i]);
+
+			// brute force over the same window
+			uint32_t first = i + 1 > WINDOW ? i + 1 - WINDOW : 0;
+			uint32_t lo = 65535, hi = 0, sum = 0;
+			uint64_t sumSquares = 0;
+			for(uint32_t j = first; j <= i; j++)
+			{
+				lo = history[j] < lo ? history[j] : lo;
+				hi = history[j] > hi ? history[j] : hi;
+				sum += history[j];
+				sumSquares += (uint32_t)history[j] * history[j];
+			}
+			sliding_stats_snapshot(&window, &snapshot);
+			errors += snapshot.count != i + 1 - first;
+			errors += snapshot.min != (int32_t)lo || snapshot.max != (int32_t)hi;
+			errors += snapshot.sum != sum || snapshot.sumSquares != sumSquares;
+		}
+		UCUNIT_CheckIsEqual(0, errors);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Running median");
+		enum { SAMPLES = 3000 };
+		static uint16_t history[SAMPLES];
+		uint16_t storage[RUNNING_MEDIAN_STORAGE(64)];
+		running_median_t median;
+		UCUNIT_CheckIsEqual(buff_err_invalid, running_median_init(&median, storage, 0));
+		UCUNIT_CheckIsEqual(buff_err_invalid, running_median_init(NULL, storage, 5));
+
+		// every window length, odd and even, against sorting the same window
+		uint32_t errors = 0;
+		for(uint32_t size = 1; size <= 64; size++)
+		{
+			running_median_init(&median, storage, size);
+			uint32_t seed = size;
+			for(uint32_t i = 0; i < SAMPLES; i++)
+			{
+				// wide values, then runs of a few repeated ones to exercise ties
+				seed = seed * 1103515245u + 12345u;
+				history[i] = (i / 100) % 2 ? (uint16_t)((seed >> 16) % 4) : (uint16_t)(seed >> 16);
+				uint16_t result = running_median_push(&median, history[i]);
+
+				uint16_t window[64];
+				uint32_t length = i + 1 < size ? i + 1 : size;
+				for(uint32_t j = 0; j < length; j++)
+				{
+					// insertion sort, upper median for even lengths
+					uint16_t value = history[i - j];
+					uint32_t k = j;
+					for(; k > 0 && window[k - 1] > value; k--)
+					{
+						window[k] = window[k - 1];
+					}
+					window[k] = value;
+				}
+				errors += result != window[length / 2];
+				errors += running_median_value(&median) != result;
+			}
+		}
+		UCUNIT_CheckIsEqual(0, errors);
+
+		// single-sample glitches on a sine never reach the output of a window of 5
+		running_median_init(&median, storage, 5);
+		uint32_t lo = 65535, hi = 0;
+		for(uint32_t i = 0; i < 500; i++)
+		{
+			uint16_t code = (uint16_t)lround(2482 + 1241 * sin(2.0 * M_PI * i / 50));
+			code = i % 37 == 0 ? 4095 : (i % 41 == 0 ? 0 : code);
+			uint16_t result = running_median_push(&median, code);
+			lo = i >= 2 && result < lo ? result : lo;
+			hi = i >= 2 && result > hi ? result : hi;
+		}
+		UCUNIT_CheckIsEqual(true, hi <= 2482 + 1241 && lo >= 2482 - 1241);
+		UCUNIT_CheckIsEqual(true, hi > 2482 + 1200 && lo < 2482 - 1200);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Fixed-point FFT");
+		static q15_t data[FFT_WORK_LENGTH];
+		static double input[FFT_WORK_LENGTH];
+		uint32_t seed = 7;
+		for(uint32_t i = 0; i < FFT_WORK_LENGTH; i++)
+		{
+			// components within +-16384 keep every magnitude within 1.0
+			seed = seed * 1103515245u + 12345u;
+			data[i] = (q15_t)((int32_t)(seed >> 17) - 16384);
+			input[i] = data[i];
+		}
+		fft_q15(data);
+
+		// against a double precision DFT, scaled by 1 / N like the transform
+		double worst = 0;
+		for(uint32_t k = 0; k < FFT_SIZE; k++)
+		{
+			double re = 0, im = 0;
+			for(uint32_t n = 0; n < FFT_SIZE; n++)
+			{
+				double angle = 2.0 * M_PI * k * n / FFT_SIZE;
+				re += input[2 * n] * cos(angle) + input[2 * n + 1] * sin(angle);
+				im += input[2 * n + 1] * cos(angle) - input[2 * n] * sin(angle);
+			}
+			re /= FFT_SIZE;
+			im /= FFT_SIZE;
+			worst = fmax(worst, fmax(fabs(data[2 * k] - re), fabs(data[2 * k + 1] - im)));
+		}
+		// about one LSB of rounding per stage
+		UCUNIT_CheckIsEqual(true, worst <= FFT_LOG2_SIZE);
+
+		// a tone between bins, with a 5 % second and 2 % third harmonic
+		uint16_t codes[FFT_SIZE];
+		fft_analysis_t analysis;
+		const double bin = 5.3;
+		for(uint32_t n = 0; n < FFT_SIZE; n++)
+		{
+			double phase = 2.0 * M_PI * bin * n / FFT_SIZE + 0.4;
+			codes[n] = (uint16_t)lround(2000 + 1200 * sin(phase) + 60 * sin(2 * phase) + 24 * sin(3 * phase));
+		}
+		UCUNIT_CheckIsEqual(buff_err_invalid, fft_analyze_block_u16(codes, FFT_SIZE - 1, 10000, data, &analysis));
+		UCUNIT_CheckIsEqual(buff_err_success, fft_analyze_block_u16(codes, FFT_SIZE, 10000, data, &analysis));
+		double mean = 0;
+		for(uint32_t n = 0; n < FFT_SIZE; n++)
+		{
+			mean += codes[n] / (double)FFT_SIZE;
+		}
+		UCUNIT_CheckIsEqual(5, analysis.peakBin);
+		UCUNIT_CheckIsEqual(true, fabs(analysis.dcOffset - mean) <= 0.5);
+		UCUNIT_CheckIsEqual(true, fabs(analysis.fundamentalMilliHz - bin * 10000 / FFT_SIZE) < 0.02 * 10000 / FFT_SIZE + 1);
+		UCUNIT_CheckIsEqual(true, fabs(analysis.amplitude - 1200.0) <= 6);
+		double thd = sqrt(60.0 * 60 + 24 * 24) / 1200 * 1e6;
+		UCUNIT_CheckIsEqual(true, fabs(analysis.thdPpm - thd) < 0.05 * thd);
+
+		// a tone too near DC for the lobes to separate is refused
+		for(uint32_t n = 0; n < FFT_SIZE; n++)
+		{
+			codes[n] = (uint16_t)lround(2000 + 1200 * sin(2.0 * M_PI * 1.28 * n / FFT_SIZE));
+		}
+		UCUNIT_CheckIsEqual(buff_err_invalid, fft_analyze_block_u16(codes, FFT_SIZE, 10000, data, &analysis));
+		UCUNIT_CheckIsEqual(1, analysis.peakBin);
+		UCUNIT_CheckIsEqual(0, analysis.thdPpm);
+
+		// a flat block has no tone
+		for(uint32_t n = 0; n < FFT_SIZE; n++)
+		{
+			codes[n] = 1234;
+		}
+		fft_analyze_block_u16(codes, FFT_SIZE, 10000, data, &analysis);
+		UCUNIT_CheckIsEqual(0, analysis.peakBin);
+		UCUNIT_CheckIsEqual(1234, analysis.dcOffset);
+		UCUNIT_CheckIsEqual(0, analysis.thdPpm);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Goertzel tone detector");
+		// whole periods of the fundamental, and a target between FFT bins
+		static const goertzel_target_t targets[] = {
+			GOERTZEL_TARGET(1, 50, 50),
+			GOERTZEL_TARGET(3, 50, 50),
+			GOERTZEL_TARGET(7, 200, 64),
+			GOERTZEL_TARGET(31, 64, 64),
+		};
+		const uint32_t targetCount = sizeof(targets) / sizeof(targets[0]);
+		const double cycles[] = { 1.0 / 50, 3.0 / 50, 7.0 / 200, 31.0 / 64 };
+		uint16_t codes[64];
+		goertzel_result_t results[4];
+		for(uint32_t n = 0; n < 64; n++)
+		{
+			double w = 2.0 * M_PI * n / 50;
+			codes[n] = (uint16_t)lround(2048 + 1241 * cos(w - 0.7) + 40 * cos(3 * w + 2.5));
+		}
+		UCUNIT_CheckIsEqual(buff_err_invalid, goertzel_block_u16(codes, 63, 2048, targets, targetCount, results));
+		UCUNIT_CheckIsEqual(buff_err_success, goertzel_block_u16(codes, 64, 2048, targets, targetCount, results));
+
+		// every target against the DFT at its frequency, in double
+		for(uint32_t t = 0; t < targetCount; t++)
+		{
+			double re = 0, im = 0;
+			for(uint32_t n = 0; n < targets[t].length; n++)
+			{
+				re += (codes[n] - 2048.0) * cos(2.0 * M_PI * cycles[t] * n);
+				im -= (codes[n] - 2048.0) * sin(2.0 * M_PI * cycles[t] * n);
+			}
+			double amplitude = 2.0 * sqrt(re * re + im * im) / targets[t].length;
+			double phase = atan2(im, re) * 18000.0 / M_PI;
+			double phaseError = fabs(remainder(results[t].phaseCentiDeg - phase, 36000.0));
+			UCUNIT_CheckIsEqual(true, fabs(results[t].amplitude - amplitude) <= 1.0);
+			// the phase of a near-silent target is noise
+			UCUNIT_CheckIsEqual(true, amplitude < 4 || phaseError <= 5);
+		}
+		UCUNIT_CheckIsEqual(1241, results[0].amplitude);
+		UCUNIT_CheckIsEqual(true, abs(results[0].phaseCentiDeg + 4011) <= 10);
+		UCUNIT_CheckIsEqual(40, results[1].amplitude);
+
+		// the offset only moves the filter state, not the result
+		goertzel_result_t shifted[4];
+		goertzel_block_u16(codes, 64, 1000, targets, 2, shifted);
+		UCUNIT_CheckIsEqual(true, abs((int32_t)shifted[0].amplitude - (int32_t)results[0].amplitude) <= 1);
+
+		// the angle approximation all the way round
+		double worst = 0;
+		for(int32_t degree = -1799; degree <= 1800; degree++)
+		{
+			double angle = degree * M_PI / 1800.0;
+			int32_t centiDeg = goertzel_atan2_centideg(llround(1e9 * sin(angle)), llround(1e9 * cos(angle)));
+			worst = fmax(worst, fabs(remainder(centiDeg - degree * 10.0, 36000.0)));
+		}
+		UCUNIT_CheckIsEqual(true, worst <= 10);
+		UCUNIT_CheckIsEqual(0, goertzel_atan2_centideg(0, 0));
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Closed-loop ADC quality");
+		UCUNIT_CheckIsEqual(3000, adc_quality_ratio_centidb(1000, 1));
+		UCUNIT_CheckIsEqual(301, adc_quality_ratio_centidb(2, 1));
+		UCUNIT_CheckIsEqual(-301, adc_quality_ratio_centidb(1, 2));
+		UCUNIT_CheckIsEqual(0, adc_quality_ratio_centidb(0, 0));
+
+		const double codesPerMv = 4096.0 / 3300.0;
+		uint16_t codes[64];
+		adc_quality_t quality;
+		UCUNIT_CheckIsEqual(buff_err_invalid, adc_quality_measure(codes, NUM_SINE_SAMPLES - 1, &quality));
+
+		// the nominal sine, then one 1 % low and 10 codes high with a 3rd harmonic and noise
+		for(uint32_t pass = 0; pass < 2; pass++)
+		{
+			uint32_t seed = 3;
+			for(uint32_t n = 0; n < 64; n++)
+			{
+				double w = 2.0 * M_PI * n / NUM_SINE_SAMPLES + 1.0;
+				double value = SINE_OFFSET_MV * codesPerMv + SINE_AMPLITUDE_MV * codesPerMv * sin(w);
+				if(pass)
+				{
+					seed = seed * 1103515245u + 12345u;
+					value += 10 - 0.01 * SINE_AMPLITUDE_MV * codesPerMv * sin(w)
+						   + 2 * sin(3 * w) + (double)(seed >> 29) - 3.5;
+				}
+				codes[n] = (uint16_t)lround(value);
+			}
+			UCUNIT_CheckIsEqual(buff_err_success, adc_quality_measure(codes, 64, &quality));
+			UCUNIT_CheckIsEqual(NUM_SINE_SAMPLES, quality.samples);
+
+			// the same fit in double precision
+			double mean = 0;
+			for(uint32_t n = 0; n < NUM_SINE_SAMPLES; n++)
+			{
+				mean += codes[n] / (double)NUM_SINE_SAMPLES;
+			}
+			double cosCoeff[ADC_QUALITY_HARMONICS + 1], sinCoeff[ADC_QUALITY_HARMONICS + 1];
+			for(uint32_t h = 1; h <= ADC_QUALITY_HARMONICS; h++)
+			{
+				cosCoeff[h] = sinCoeff[h] = 0;
+				for(uint32_t n = 0; n < NUM_SINE_SAMPLES; n++)
+				{
+					cosCoeff[h] += 2.0 / NUM_SINE_SAMPLES * codes[n] * cos(2.0 * M_PI * h * n / NUM_SINE_SAMPLES);
+					sinCoeff[h] += 2.0 / NUM_SINE_SAMPLES * codes[n] * sin(2.0 * M_PI * h * n / NUM_SINE_SAMPLES);
+				}
+			}
+			double noise = 0, distortion = 0;
+			for(uint32_t n = 0; n < NUM_SINE_SAMPLES; n++)
+			{
+				double fit = mean;
+				for(uint32_t h = 1; h <= ADC_QUALITY_HARMONICS; h++)
+				{
+					fit += cosCoeff[h] * cos(2.0 * M_PI * h * n / NUM_SINE_SAMPLES)
+						 + sinCoeff[h] * sin(2.0 * M_PI * h * n / NUM_SINE_SAMPLES);
+				}
+				noise += (codes[n] - fit) * (codes[n] - fit);
+			}
+			for(uint32_t h = 2; h <= ADC_QUALITY_HARMONICS; h++)
+			{
+				distortion += NUM_SINE_SAMPLES * (cosCoeff[h] * cosCoeff[h] + sinCoeff[h] * sinCoeff[h]) / 2;
+			}
+			double amplitude = hypot(cosCoeff[1], sinCoeff[1]);
+			double signal = NUM_SINE_SAMPLES * amplitude * amplitude / 2;
+			double snr = 1000 * log10(signal / noise);
+			double sinad = 1000 * log10(signal / (noise + distortion));
+			// within 0.1 dB, the fit's table rounding against a 12 bit noise floor
+			UCUNIT_CheckIsEqual(true, fabs(quality.snrCentiDb - snr) <= 10);
+			UCUNIT_CheckIsEqual(true, fabs(quality.sinadCentiDb - sinad) <= 10);
+			UCUNIT_CheckIsEqual(true, fabs(quality.enobCentiBits - (sinad - 176) / 6.02) <= 3);
+
+			double gainPpm = (amplitude / (SINE_AMPLITUDE_MV * codesPerMv) - 1) * 1e6;
+			double offsetUv = (mean - SINE_OFFSET_MV * codesPerMv) / codesPerMv * 1000;
+			UCUNIT_CheckIsEqual(true, fabs(quality.gainErrorPpm - gainPpm) <= 10);
+			UCUNIT_CheckIsEqual(true, fabs(quality.offsetErrorUv - offsetUv) <= 5);
+			UCUNIT_CheckIsEqual(true, pass ? quality.sinadCentiDb < quality.snrCentiDb - 50 : quality.enobCentiBits > 1100);
+		}
+		UCUNIT_CheckIsEqual(true, abs(quality.gainErrorPpm + 10000) < 1000);
+		UCUNIT_CheckIsEqual(true, abs(quality.offsetErrorUv - 8057) < 1000);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Fixed-point filter kernels");
+		// a noisy sine in 12 bit codes, filtered in blocks of 64 against one pass in double
+		enum { samples = 256, block = 64 };
+		q15_t input[samples];
+		uint32_t seed = 7;
+		for(uint32_t n = 0; n < samples; n++)
+		{
+			seed = seed * 1103515245u + 12345u;
+			input[n] = (q15_t)lround(2500 + 1200 * sin(2.0 * M_PI * n / 50) + (double)(seed >> 25) - 64);
+		}
+
+		// Butterworth lowpass at fs / 10 in 1.15, and at fs / 20 in both formats
+		q15_t q15Coeffs[2][6] = { { 1105, 0, 2210, 1105, 18727, -6763 },
+		                          { 329, 0, 658, 329, 25576, -10508 } };
+		q31_t q31Coeffs[5] = { 21564350, 43128699, 21564350, 1676130396, -688645970 };
+		double worst[3] = {0};
+		for(uint32_t filter = 0; filter < 3; filter++)
+		{
+			q15_t out[samples];
+			memcpy(out, input, sizeof(out));
+			q15_t state15[4];
+			q31_t state31[4];
+			q31_t wide[block];
+			arm_biquad_casd_df1_inst_q15 biquad15;
+			arm_biquad_casd_df1_inst_q31 biquad31;
+			arm_biquad_cascade_df1_init_q15(&biquad15, 1, q15Coeffs[filter < 2 ? filter : 1], state15, 1);
+			arm_biquad_cascade_df1_init_q31(&biquad31, 1, q31Coeffs, state31, 1);
+			for(uint32_t start = 0; start < samples; start += block)
+			{
+				if(filter < 2)
+				{
+					arm_biquad_cascade_df1_q15(&biquad15, &out[start], &out[start], block);
+				}
+				else
+				{
+					arm_q15_to_q31(&out[start], wide, block);
+					arm_biquad_cascade_df1_q31(&biquad31, wide, wide, block);
+					arm_q31_to_q15(wide, &out[start], block);
+				}
+			}
+
+			// the same filter from the rounded coefficients, in double
+			double c[5];
+			for(uint32_t k = 0; k < 5; k++)
+			{
+				c[k] = filter < 2 ? 2.0 * q15Coeffs[filter][k ? k + 1 : 0] / 32768.0
+				                  : 2.0 * q31Coeffs[k] / 2147483648.0;
+			}
+			double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+			for(uint32_t n = 0; n < samples; n++)
+			{
+				double y = c[0] * input[n] + c[1] * x1 + c[2] * x2 + c[3] * y1 + c[4] * y2;
+				x2 = x1;
+				x1 = input[n];
+				y2 = y1;
+				y1 = y;
+				worst[filter] = fmax(worst[filter], fabs(out[n] - y));
+			}
+		}
+		// truncation in the feedback costs codes in 1.15, more the nearer the
+		// poles are to DC, and under one in 1.31
+		UCUNIT_CheckIsEqual(true, worst[0] <= 4);
+		UCUNIT_CheckIsEqual(true, worst[1] <= 12);
+		UCUNIT_CheckIsEqual(true, worst[2] <= 1);
+		UCUNIT_CheckIsEqual(true, worst[2] < worst[1]);
+
+		// FIR against the convolution, across block boundaries
+		q15_t taps[8] = { 117, 1248, 5277, 9742, 9742, 5277, 1248, 117 };
+		q15_t firState[8 + block - 1];
+		arm_fir_instance_q15 fir;
+		UCUNIT_CheckIsEqual(ARM_MATH_SUCCESS, arm_fir_init_q15(&fir, 8, taps, firState, block));
+		q15_t firOut[samples];
+		memcpy(firOut, input, sizeof(firOut));
+		for(uint32_t start = 0; start < samples; start += block)
+		{
+			arm_fir_q15(&fir, &firOut[start], &firOut[start], block);
+		}
+		double firWorst = 0;
+		for(uint32_t n = 0; n < samples; n++)
+		{
+			double y = 0;
+			for(uint32_t k = 0; k < 8 && k <= n; k++)
+			{
+				y += taps[7 - k] / 32768.0 * input[n - k];
+			}
+			firWorst = fmax(firWorst, fabs(firOut[n] - y));
+		}
+		UCUNIT_CheckIsEqual(true, firWorst < 1);
+
+		// the DC blocker against its recurrence, then its mean once settled,
+		// on a stimulus that carries on from one pass to the next. Without
+		// error feedback, truncation would leave it 0.5 / (1 - pole) = 50 low.
+		dc_blocker_t blocker;
+		dc_blocker_init(&blocker, 32440, 2048);
+		double x1 = 0, y1 = 0, blockerWorst = 0, settledSum = 0;
+		for(uint32_t pass = 0; pass < 8; pass++)
+		{
+			q15_t in[samples];
+			q15_t out[samples];
+			for(uint32_t n = 0; n < samples; n++)
+			{
+				in[n] = (q15_t)lround(2500 + 1200 * sin(2.0 * M_PI * (pass * samples + n) / 50));
+			}
+			memcpy(out, in, sizeof(out));
+			for(uint32_t start = 0; start < samples; start += block)
+			{
+				dc_blocker_q15(&blocker, &out[start], block);
+			}
+			for(uint32_t n = 0; n < samples; n++)
+			{
+				double y = in[n] - x1 + 32440 / 32768.0 * y1;
+				x1 = in[n];
+				y1 = y;
+				blockerWorst = fmax(blockerWorst, fabs(out[n] - 2048 - y));
+				// the last 5 periods
+				settledSum += pass == 7 && n >= samples - 250 ? out[n] : 0;
+			}
+		}
+		UCUNIT_CheckIsEqual(true, blockerWorst < 1);
+		UCUNIT_CheckIsEqual(true, fabs(settledSum / 250 - 2048) < 1);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Filter chain as shipped");
+		enum { BLOCK = 64, BLOCKS = 40 };
+		q15_t block[BLOCK];
+		UCUNIT_CheckIsEqual(4, FILTER_CHAIN_STAGES);
+
+		/**
+		 * The DAC sine around 2000 mV, from the first block on. Primed, the
+		 * chain starts at the DC blocker's mid-scale instead of near 4530,
+		 * or ramping up from 0 V, and every output is a 12 bit code.
+		 */
+		filter_chain_init();
+		int32_t lo = INT32_MAX, hi = INT32_MIN;
+		int32_t firstLo = INT32_MAX, firstHi = INT32_MIN;
+		bool inRange = true;
+		for(uint32_t b = 0; b < BLOCKS; b++)
+		{
+			for(uint32_t i = 0; i < BLOCK; i++)
+			{
+				block[i] = (q15_t)lround(2482 + 1241 * sin(2.0 * M_PI * (b * BLOCK + i) / 50));
+			}
+			filter_chain_process(block, BLOCK);
+			for(uint32_t i = 0; i < BLOCK; i++)
+			{
+				inRange = inRange && block[i] >= 0 && block[i] <= 4095;
+				if(b == 0)
+				{
+					firstLo = block[i] < firstLo ? block[i] : firstLo;
+					firstHi = block[i] > firstHi ? block[i] : firstHi;
+				}
+				if(b >= BLOCKS / 2)
+				{
+					lo = block[i] < lo ? block[i] : lo;
+					hi = block[i] > hi ? block[i] : hi;
+				}
+			}
+		}
+		UCUNIT_CheckIsEqual(true, inRange);
+		UCUNIT_CheckIsEqual(true, firstLo > 2048 - 1400 && firstHi < 2048 + 1400);
+		// settled: centred on mid-scale, the sine passed at close to unity gain
+		UCUNIT_CheckIsEqual(true, abs((lo + hi) / 2 - 2048) < 30);
+		UCUNIT_CheckIsEqual(true, (hi - lo) / 2 > 1100 && (hi - lo) / 2 < 1300);
+
+		// a steady level comes out at mid-scale from the first sample
+		filter_chain_init();
+		for(uint32_t i = 0; i < BLOCK; i++)
+		{
+			block[i] = 2482;
+		}
+		filter_chain_process(block, BLOCK);
+		int32_t worst = 0;
+		for(uint32_t i = 0; i < BLOCK; i++)
+		{
+			worst = abs(block[i] - 2048) > worst ? abs(block[i] - 2048) : worst;
+		}
+		UCUNIT_CheckIsEqual(true, worst <= 2);
+
+		// rail to rail steps overshoot, and are clamped to codes
+		for(uint32_t b = 0; b < 4; b++)
+		{
+			for(uint32_t i = 0; i < BLOCK; i++)
+			{
+				block[i] = (i / 16) % 2 ? 4095 : 0;
+			}
+			filter_chain_process(block, BLOCK);
+			for(uint32_t i = 0; i < BLOCK; i++)
+			{
+				inRange = inRange && block[i] >= 0 && block[i] <= 4095;
+			}
+		}
+		UCUNIT_CheckIsEqual(true, inRange);
+		UCUNIT_CheckIsEqual(0, filter_chain_process(block, 0));
+		filter_chain_log();
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("CIC decimator with compensation");
+		decimator_t decimator;
+		uint16_t out = 0;
+		UCUNIT_CheckIsEqual(buff_err_invalid, decimator_init(&decimator, 0));
+		UCUNIT_CheckIsEqual(buff_err_invalid, decimator_init(&decimator, DECIMATOR_MAX_RATIO + 1));
+		UCUNIT_CheckIsEqual(buff_err_invalid, decimator_init(NULL, 4));
+
+		// DC passes exactly, including full scale, once the filters fill
+		UCUNIT_CheckIsEqual(buff_err_success, decimator_init(&decimator, DECIMATOR_MAX_RATIO));
+		uint32_t outputs = 0;
+		for(uint32_t n = 0; n < 10 * DECIMATOR_MAX_RATIO; n++)
+		{
+			outputs += decimator_push(&decimator, 4095, &out);
+		}
+		UCUNIT_CheckIsEqual(10, outputs);
+		UCUNIT_CheckIsEqual(4095 << DECIMATOR_FRACTION_BITS, out);
+		UCUNIT_CheckIsEqual(4095, decimator_to_code(out));
+
+		/**
+		 * A sine of 50 output samples per period, plus Gaussian noise of
+		 * 2 codes, quantized to 12 bits. Each output is fitted against the
+		 * sine delayed by the filters; the residual shrinks by about sqrt(ratio).
+		 */
+		const uint32_t ratios[] = { 4, 16, 64 };
+		for(uint32_t r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++)
+		{
+			uint32_t ratio = ratios[r];
+			decimator_init(&decimator, ratio);
+			double delay = DECIMATOR_CIC_ORDER * (ratio - 1) / 2.0 + ratio;
+			double noise = 0;
+			uint32_t count = 0, index = 0;
+			uint32_t seed = 11;
+			for(uint32_t n = 0; n < 400 * ratio; n++)
+			{
+				double w = 2.0 * M_PI / (50.0 * ratio);
+				// Box-Muller from two uniform draws
+				seed = seed * 1103515245u + 12345u;
+				double u1 = ((seed >> 8) + 1.0) / 16777217.0;
+				seed = seed * 1103515245u + 12345u;
+				double u2 = (seed >> 8) / 16777216.0;
+				double gaussian = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+				uint16_t code = (uint16_t)lround(2048 + 1500 * sin(w * n) + 2.0 * gaussian);
+				if(decimator_push(&decimator, code, &out) && ++index > 10)
+				{
+					double expected = 2048 + 1500 * sin(w * (n - delay));
+					double error = out / (double)(1 << DECIMATOR_FRACTION_BITS) - expected;
+					noise += error * error;
+					count++;
+				}
+			}
+			double residual = sqrt(noise / count);
+			// uncompensated, the CIC's 0.2 % droop would leave 2 codes of sine here
+			// and swamp the noise at the higher ratios
+			UCUNIT_CheckIsEqual(true, residual < 2.0 / sqrt(ratio) * 1.3);
+			UCUNIT_CheckIsEqual(true, residual > 2.0 / sqrt(ratio) * 0.7);
+			// half a bit per doubling of the ratio
+			double bitsGained = 0.5 * log2(4.0 / (residual * residual));
+			UCUNIT_CheckIsEqual(true, fabs(bitsGained - 0.5 * log2(ratio)) < 0.4);
+		}
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Trigger and pre/post-trigger capture");
+		enum { BLOCK = 16, PRE = 4, SAMPLES = 1000 };
+		static uint16_t stimulus[SAMPLES];
+		uint16_t storage[2 * BLOCK];
+		uint16_t history[PRE];
+		pingpong_t pp;
+		trigger_t trigger;
+		size_t count = 0;
+		trigger_config_t config = { .mode = trigger_mode_free_run, .preTrigger = BLOCK };
+		UCUNIT_CheckIsEqual(buff_err_invalid, trigger_init(&trigger, &config, history, BLOCK));
+		config.preTrigger = PRE;
+		UCUNIT_CheckIsEqual(buff_err_invalid, trigger_init(&trigger, &config, NULL, BLOCK));
+		config.mode = trigger_mode_window;
+		config.low = 10;
+		config.high = 9;
+		UCUNIT_CheckIsEqual(buff_err_invalid, trigger_init(&trigger, &config, history, BLOCK));
+
+		// free run hands over every sample, in order, with or without history
+		for(uint32_t pre = 0; pre <= PRE; pre += PRE)
+		{
+			config = (trigger_config_t){ .mode = trigger_mode_free_run, .preTrigger = pre };
+			pingpong_init(&pp, storage, BLOCK);
+			UCUNIT_CheckIsEqual(buff_err_success, trigger_init(&trigger, &config, history, BLOCK));
+			uint32_t errors = 0, blocks = 0;
+			for(uint16_t i = 0; i < 5 * BLOCK; i++)
+			{
+				if(trigger_push(&trigger, &pp, i))
+				{
+					const uint16_t* block = pingpong_acquire(&pp, &count);
+					for(uint32_t j = 0; j < count; j++)
+					{
+						errors += block[j] != blocks * BLOCK + j;
+					}
+					blocks++;
+					pingpong_release(&pp);
+				}
+			}
+			UCUNIT_CheckIsEqual(0, errors);
+			UCUNIT_CheckIsEqual(5, blocks);
+		}
+
+		/**
+		 * Edges on a sine of 50 samples per period. Each capture must be the
+		 * BLOCK stimulus samples ending where it completed, with the crossing
+		 * at index PRE. Captures are short, so every period gives one.
+		 */
+		for(uint32_t i = 0; i < SAMPLES; i++)
+		{
+			stimulus[i] = (uint16_t)lround(2048 + 1000 * sin(2.0 * M_PI * i / 50));
+		}
+		const trigger_mode edges[] = { trigger_mode_rising, trigger_mode_falling };
+		for(uint32_t e = 0; e < 2; e++)
+		{
+			config = (trigger_config_t){ .mode = edges[e], .level = 2500, .hysteresis = 50, .preTrigger = PRE };
+			pingpong_init(&pp, storage, BLOCK);
+			trigger_init(&trigger, &config, history, BLOCK);
+			uint32_t errors = 0, blocks = 0;
+			for(uint32_t i = 0; i < SAMPLES; i++)
+			{
+				if(trigger_push(&trigger, &pp, stimulus[i]))
+				{
+					const uint16_t* block = pingpong_acquire(&pp, &count);
+					uint32_t first = i + 1 - BLOCK;
+					errors += memcmp(block, stimulus + first, BLOCK * sizeof(uint16_t)) != 0;
+					if(edges[e] == trigger_mode_rising)
+					{
+						errors += !(block[PRE - 1] < 2500 && block[PRE] >= 2500);
+					}
+					else
+					{
+						errors += !(block[PRE - 1] > 2500 && block[PRE] <= 2500);
+					}
+					blocks++;
+					pingpong_release(&pp);
+				}
+			}
+			UCUNIT_CheckIsEqual(0, errors);
+			UCUNIT_CheckIsEqual(SAMPLES / 50, blocks);
+			UCUNIT_CheckIsEqual(blocks, trigger.triggers);
+			UCUNIT_CheckIsEqual(0, trigger.forced);
+		}
+
+		// dithering across the level fires once, until the signal leaves the band
+		config = (trigger_config_t){ .mode = trigger_mode_rising, .level = 100, .hysteresis = 10 };
+		pingpong_init(&pp, storage, 2);
+		trigger_init(&trigger, &config, history, 2);
+		trigger_push(&trigger, &pp, 80);
+		for(uint32_t i = 0; i < 40; i++)
+		{
+			trigger_push(&trigger, &pp, i % 2 ? 95 : 101);
+			pingpong_release(&pp);
+		}
+		UCUNIT_CheckIsEqual(1, trigger.triggers);
+		trigger_push(&trigger, &pp, 89);
+		trigger_push(&trigger, &pp, 100);
+		UCUNIT_CheckIsEqual(2, trigger.triggers);
+
+		// level fires on the first sample at or above it
+		config = (trigger_config_t){ .mode = trigger_mode_level, .level = 3000, .preTrigger = PRE };
+		pingpong_init(&pp, storage, BLOCK);
+		trigger_init(&trigger, &config, history, BLOCK);
+		uint32_t completed = 0;
+		for(uint32_t i = 0; i < SAMPLES && !completed; i++)
+		{
+			completed = trigger_push(&trigger, &pp, stimulus[i]) ? i : 0;
+		}
+		const uint16_t* block = pingpong_acquire(&pp, &count);
+		UCUNIT_CheckIsEqual(true, block[PRE] >= 3000 && block[PRE - 1] < 3000);
+		UCUNIT_CheckIsEqual(stimulus[completed], block[BLOCK - 1]);
+		pingpong_release(&pp);
+
+		// a window catches a glitch in either direction, and holdoff skips samples
+		config = (trigger_config_t){ .mode = trigger_mode_window, .low = 1000, .high = 3100,
+			                         .preTrigger = PRE, .holdoff = 30 };
+		pingpong_init(&pp, storage, BLOCK);
+		trigger_init(&trigger, &config, history, BLOCK);
+		uint16_t glitchy[SAMPLES];
+		memcpy(glitchy, stimulus, sizeof(glitchy));
+		glitchy[100] = 4095;
+		glitchy[105] = 0;   // inside the first capture
+		glitchy[140] = 0;   // inside the holdoff
+		glitchy[200] = 0;
+		uint32_t ends[4], captures = 0;
+		for(uint32_t i = 0; i < SAMPLES; i++)
+		{
+			if(trigger_push(&trigger, &pp, glitchy[i]))
+			{
+				block = pingpong_acquire(&pp, &count);
+				if(captures < 4)
+				{
+					ends[captures] = i;
+				}
+				captures++;
+				UCUNIT_CheckIsEqual(true, block[PRE] < 1000 || block[PRE] > 3100);
+				pingpong_release(&pp);
+			}
+		}
+		UCUNIT_CheckIsEqual(2, captures);
+		UCUNIT_CheckIsEqual(100 + BLOCK - PRE - 1, ends[0]);
+		UCUNIT_CheckIsEqual(200 + BLOCK - PRE - 1, ends[1]);
+
+		// with nothing to trigger on, auto forces a capture after the timeout
+		config = (trigger_config_t){ .mode = trigger_mode_rising, .level = 3000,
+			                         .preTrigger = PRE, .autoTimeout = 50 };
+		pingpong_init(&pp, storage, BLOCK);
+		trigger_init(&trigger, &config, history, BLOCK);
+		completed = 0;
+		for(uint32_t i = 0; i < SAMPLES && !completed; i++)
+		{
+			completed = trigger_push(&trigger, &pp, 2048) ? i : 0;
+		}
+		// the forced sample is the 50th after the history filled, then the block fills
+		UCUNIT_CheckIsEqual(PRE + 50 - 1 + BLOCK - PRE - 1, completed);
+		UCUNIT_CheckIsEqual(1, trigger.forced);
+		UCUNIT_CheckIsEqual(0, trigger.triggers);
+		UCUNIT_TestcaseEnd();
+	}
+
+	{
+		UCUNIT_TestcaseBegin("Histogram percentiles");
+		enum { SAMPLES = 20000, BLOCK = 64 };
+		static uint16_t samples[SAMPLES];
+		static uint16_t sorted[SAMPLES];
+		static histogram_t whole, merged, block;
+		uint16_t code = 0;
+		UCUNIT_CheckIsEqual(true, sizeof(histogram_t) < 512);
+		histogram_reset(&whole);
+		UCUNIT_CheckIsEqual(buff_err_empty, histogram_percentile(&whole, 5000, &code));
+
+		// a sine plus a few glitches at either rail, in blocks and all at once
+		histogram_reset(&merged);
+		for(uint32_t i = 0; i < SAMPLES; i++)
+		{
+			samples[i] = (uint16_t)lround(2482 + 1241 * sin(2.0 * M_PI * i / 50.3));
+			samples[i] = i % 97 == 0 ? 4095 : (i % 89 == 0 ? 3 : samples[i]);
+		}
+		histogram_add_block_u16(&whole, samples, SAMPLES);
+		for(uint32_t i = 0; i < SAMPLES; i += BLOCK)
+		{
+			histogram_reset(&block);
+			histogram_add_block_u16(&block, samples + i, SAMPLES - i < BLOCK ? SAMPLES - i : BLOCK);
+			histogram_merge(&merged, &block);
+		}
+		UCUNIT_CheckIsEqual(0, memcmp(&whole, &merged, sizeof(histogram_t)));
+		UCUNIT_CheckIsEqual(SAMPLES, histogram_samples(&whole));
+		UCUNIT_CheckIsEqual(buff_err_invalid, histogram_percentile(&whole, 10001, &code));
+
+		// within a bin of the exact nearest-rank percentile
+		memcpy(sorted, samples, sizeof(sorted));
+		for(uint32_t i = 1; i < SAMPLES; i++)
+		{
+			uint16_t value = sorted[i];
+			uint32_t k = i;
+			for(; k > 0 && sorted[k - 1] > value; k--)
+			{
+				sorted[k] = sorted[k - 1];
+			}
+			sorted[k] = value;
+		}
+		const uint32_t shares[] = { 0, 100, 2500, 5000, 9500, 9900, 9950, 10000 };
+		uint32_t worst = 0;
+		for(uint32_t i = 0; i < sizeof(shares) / sizeof(shares[0]); i++)
+		{
+			uint32_t rank = (SAMPLES * shares[i] + 9999) / 10000;
+			uint16_t exact = sorted[rank ? rank - 1 : 0];
+			UCUNIT_CheckIsEqual(buff_err_success, histogram_percentile(&whole, shares[i], &code));
+			uint32_t error = code > exact ? code - exact : exact - code;
+			worst = error > worst ? error : worst;
+		}
+		UCUNIT_CheckIsEqual(true, worst < HISTOGRAM_BIN_WIDTH);
+		histogram_percentile(&whole, 10000, &code);
+		UCUNIT_CheckIsEqual(true, code >= 4095 - HISTOGRAM_BIN_WIDTH);
+
+		/**
+		 * Past 65535 in a bin, counts halve instead of overflowing. Added
+		 * directly and folded in block by block, the histogram keeps both
+		 * the number of samples and the shape, so the percentiles survive.
+		 */
+		enum { PASSES = 200 };
+		histogram_reset(&whole);
+		histogram_reset(&merged);
+		for(uint32_t pass = 0; pass < PASSES; pass++)
+		{
+			histogram_add_block_u16(&whole, samples, SAMPLES);
+			for(uint32_t i = 0; i < SAMPLES; i += BLOCK)
+			{
+				histogram_reset(&block);
+				histogram_add_block_u16(&block, samples + i, SAMPLES - i < BLOCK ? SAMPLES - i : BLOCK);
+				histogram_merge(&merged, &block);
+			}
+		}
+		const histogram_t* halved[] = { &whole, &merged };
+		for(uint32_t h = 0; h < 2; h++)
+		{
+			UCUNIT_CheckIsEqual(true, halved[h]->halvings >= 1);
+			double represented = (double)histogram_samples(halved[h]);
+			UCUNIT_CheckIsEqual(true, fabs(represented / ((double)PASSES * SAMPLES) - 1) < 0.01);
+			worst = 0;
+			for(uint32_t i = 1; i < sizeof(shares) / sizeof(shares[0]) - 1; i++)
+			{
+				uint32_t rank = (SAMPLES * shares[i] + 9999) / 10000;
+				histogram_percentile(halved[h], shares[i], &code);
+				uint32_t error = abs((int32_t)code - sorted[rank - 1]);
+				worst = error > worst ? error : worst;
+			}
+			UCUNIT_CheckIsEqual(true, worst < HISTOGRAM_BIN_WIDTH);
+		}
+
+		// merging full bins, in either direction, never wraps a count
+		histogram_reset(&merged);
+		for(uint32_t i = 0; i < HISTOGRAM_BINS; i++)
+		{
+			merged.bins[i] = HISTOGRAM_MAX_COUNT;
+			merged.total += HISTOGRAM_MAX_COUNT;
+		}
+		block = merged;
+		histogram_merge(&merged, &block);
+		UCUNIT_CheckIsEqual(true, merged.halvings >= 1 && merged.bins[0] >= 16384);
+		histogram_merge(&block, &merged);
+		UCUNIT_CheckIsEqual(true, block.halvings >= 2 && block.bins[0] >= 16384);
+		histogram_percentile(&block, 5000, &code);
+		UCUNIT_CheckIsEqual(true, abs((int32_t)code - 2048) < HISTOGRAM_BIN_WIDTH);
+		UCUNIT_TestcaseEnd();
+	}
+
+	UCUNIT_WriteSummary();
+
+	return ucunit_testcases_failed != 0;
+}